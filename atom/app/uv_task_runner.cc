@@ -6,28 +6,87 @@
 
 #include "atom/app/uv_task_runner.h"
 
-#include "base/stl_util.h"
-
 namespace atom {
 
-UvTaskRunner::UvTaskRunner(uv_loop_t* loop) : loop_(loop) {
+UvTaskRunner::PendingTask::PendingTask(base::OnceClosure task,
+                                       base::TimeTicks run_time,
+                                       uint64_t sequence_num)
+    : task(std::move(task)),
+      run_time(run_time),
+      sequence_num(sequence_num) {
+}
+
+UvTaskRunner::PendingTask::PendingTask(PendingTask&& other) = default;
+
+UvTaskRunner::PendingTask::~PendingTask() {
+}
+
+UvTaskRunner::PendingTask& UvTaskRunner::PendingTask::operator=(
+    PendingTask&& other) = default;
+
+bool UvTaskRunner::PendingTask::operator<(const PendingTask& other) const {
+  // std::priority_queue puts the greatest element on top, so the earliest
+  // task has to compare greatest.
+  if (run_time != other.run_time)
+    return run_time > other.run_time;
+  return sequence_num > other.sequence_num;
+}
+
+UvTaskRunner::UvTaskRunner(uv_loop_t* loop)
+    : loop_(loop),
+      loop_thread_id_(base::PlatformThread::CurrentId()),
+      next_sequence_num_(0),
+      wakeup_(new uv_async_t),
+      wakeup_referenced_(false),
+      timer_(new uv_timer_t) {
+  uv_async_init(loop_, wakeup_, UvTaskRunner::OnWakeup);
+  wakeup_->data = this;
+  // The wakeup handle only keeps the loop alive while tasks are queued.
+  uv_unref(reinterpret_cast<uv_handle_t*>(wakeup_));
+
+  uv_timer_init(loop_, timer_);
+  timer_->data = this;
 }
 
 UvTaskRunner::~UvTaskRunner() {
-  for (auto& iter : tasks_) {
-    uv_unref(reinterpret_cast<uv_handle_t*>(iter.first));
-    delete iter.first;
-  }
+  // The handles are freed once the loop has closed them, which may never
+  // happen when the loop is already done.
+  wakeup_->data = nullptr;
+  uv_close(reinterpret_cast<uv_handle_t*>(wakeup_), UvTaskRunner::OnClose);
+  timer_->data = nullptr;
+  uv_close(reinterpret_cast<uv_handle_t*>(timer_), UvTaskRunner::OnClose);
 }
 
 bool UvTaskRunner::PostDelayedTask(const base::Location& from_here,
                                    base::OnceClosure task,
                                    base::TimeDelta delay) {
-  auto* timer = new uv_timer_t;
-  timer->data = this;
-  uv_timer_init(loop_, timer);
-  uv_timer_start(timer, UvTaskRunner::OnTimeout, delay.InMilliseconds(), 0);
-  tasks_[timer] = std::move(task);
+  base::TimeTicks run_time;
+  if (delay > base::TimeDelta())
+    run_time = base::TimeTicks::Now() + delay;
+
+  bool on_loop_thread = IsLoopThread();
+  {
+    base::AutoLock auto_lock(incoming_lock_);
+    uint64_t sequence_num = next_sequence_num_++;
+    if (on_loop_thread && !run_time.is_null()) {
+      delayed_tasks_.emplace(std::move(task), run_time, sequence_num);
+    } else {
+      incoming_tasks_.emplace_back(std::move(task), run_time, sequence_num);
+    }
+  }
+
+  if (on_loop_thread) {
+    if (!run_time.is_null()) {
+      ScheduleTimer();
+      return true;
+    }
+    if (!wakeup_referenced_) {
+      uv_ref(reinterpret_cast<uv_handle_t*>(wakeup_));
+      wakeup_referenced_ = true;
+    }
+  }
+  // Sends are coalesced by libuv until the loop handles the wakeup.
+  uv_async_send(wakeup_);
   return true;
 }
 
@@ -42,21 +101,82 @@ bool UvTaskRunner::PostNonNestableDelayedTask(
   return PostDelayedTask(from_here, std::move(task), delay);
 }
 
+bool UvTaskRunner::IsLoopThread() const {
+  return base::PlatformThread::CurrentId() == loop_thread_id_;
+}
+
+void UvTaskRunner::DrainIncomingTasks() {
+  // Tasks posted while draining are run on the next wakeup, so a task that
+  // keeps reposting itself can not starve the loop.
+  std::vector<PendingTask> tasks;
+  {
+    base::AutoLock auto_lock(incoming_lock_);
+    tasks.swap(incoming_tasks_);
+  }
+
+  bool has_delayed_tasks = false;
+  for (PendingTask& pending_task : tasks) {
+    if (pending_task.run_time.is_null()) {
+      std::move(pending_task.task).Run();
+    } else {
+      delayed_tasks_.push(std::move(pending_task));
+      has_delayed_tasks = true;
+    }
+  }
+  if (has_delayed_tasks)
+    ScheduleTimer();
+
+  base::AutoLock auto_lock(incoming_lock_);
+  if (incoming_tasks_.empty() && wakeup_referenced_) {
+    uv_unref(reinterpret_cast<uv_handle_t*>(wakeup_));
+    wakeup_referenced_ = false;
+  }
+}
+
+void UvTaskRunner::RunDueDelayedTasks() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  while (!delayed_tasks_.empty() && delayed_tasks_.top().run_time <= now) {
+    base::OnceClosure task =
+        std::move(const_cast<PendingTask&>(delayed_tasks_.top()).task);
+    delayed_tasks_.pop();
+    std::move(task).Run();
+  }
+  ScheduleTimer();
+}
+
+void UvTaskRunner::ScheduleTimer() {
+  if (delayed_tasks_.empty()) {
+    uv_timer_stop(timer_);
+    return;
+  }
+
+  base::TimeDelta delay =
+      delayed_tasks_.top().run_time - base::TimeTicks::Now();
+  uint64_t timeout = delay > base::TimeDelta() ?
+      static_cast<uint64_t>(delay.InMillisecondsRoundedUp()) : 0;
+  uv_timer_start(timer_, UvTaskRunner::OnTimeout, timeout, 0);
+}
+
+// static
+void UvTaskRunner::OnWakeup(uv_async_t* handle) {
+  UvTaskRunner* self = static_cast<UvTaskRunner*>(handle->data);
+  if (self)
+    self->DrainIncomingTasks();
+}
+
 // static
 void UvTaskRunner::OnTimeout(uv_timer_t* timer) {
   UvTaskRunner* self = static_cast<UvTaskRunner*>(timer->data);
-  if (!ContainsKey(self->tasks_, timer))
-    return;
-
-  std::move(self->tasks_[timer]).Run();
-  self->tasks_.erase(timer);
-  uv_timer_stop(timer);
-  uv_close(reinterpret_cast<uv_handle_t*>(timer), UvTaskRunner::OnClose);
+  if (self)
+    self->RunDueDelayedTasks();
 }
 
 // static
 void UvTaskRunner::OnClose(uv_handle_t* handle) {
-  delete reinterpret_cast<uv_timer_t*>(handle);
+  if (handle->type == UV_ASYNC)
+    delete reinterpret_cast<uv_async_t*>(handle);
+  else
+    delete reinterpret_cast<uv_timer_t*>(handle);
 }
 
 }  // namespace atom
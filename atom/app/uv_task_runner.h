@@ -5,20 +5,27 @@
 #ifndef ATOM_APP_UV_TASK_RUNNER_H_
 #define ATOM_APP_UV_TASK_RUNNER_H_
 
-#include <map>
+#include <queue>
+#include <vector>
 
 #include "base/callback.h"
 #include "base/location.h"
 #include "base/single_thread_task_runner.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
 namespace atom {
 
 // TaskRunner implementation that posts tasks into libuv's default loop.
+//
+// Immediate tasks are queued and drained by a single uv_async_t, delayed
+// tasks are kept in a heap served by a single uv_timer_t, so posting a task
+// does not allocate a libuv handle.
 class UvTaskRunner : public base::SingleThreadTaskRunner {
  public:
   explicit UvTaskRunner(uv_loop_t* loop);
-  ~UvTaskRunner() override;
 
   // base::SingleThreadTaskRunner:
   bool PostDelayedTask(const base::Location& from_here,
@@ -32,12 +39,54 @@ class UvTaskRunner : public base::SingleThreadTaskRunner {
       base::TimeDelta delay) override;
 
  private:
+  struct PendingTask {
+    PendingTask(base::OnceClosure task,
+                base::TimeTicks run_time,
+                uint64_t sequence_num);
+    PendingTask(PendingTask&& other);
+    ~PendingTask();
+
+    PendingTask& operator=(PendingTask&& other);
+
+    // Orders the delayed heap by run time, then by posting order.
+    bool operator<(const PendingTask& other) const;
+
+    base::OnceClosure task;
+    // Null for immediate tasks.
+    base::TimeTicks run_time;
+    uint64_t sequence_num;
+  };
+
+  ~UvTaskRunner() override;
+
+  bool IsLoopThread() const;
+
+  // Runs the immediate tasks and moves delayed ones posted from other threads
+  // into |delayed_tasks_|.
+  void DrainIncomingTasks();
+  // Runs the delayed tasks that are due.
+  void RunDueDelayedTasks();
+  // Restarts |timer_| for the earliest delayed task.
+  void ScheduleTimer();
+
+  static void OnWakeup(uv_async_t* handle);
   static void OnTimeout(uv_timer_t* timer);
   static void OnClose(uv_handle_t* handle);
 
   uv_loop_t* loop_;
+  const base::PlatformThreadId loop_thread_id_;
+
+  // Tasks can be posted from any thread, they are handed to the loop thread
+  // through |incoming_tasks_| and |wakeup_|.
+  base::Lock incoming_lock_;
+  std::vector<PendingTask> incoming_tasks_;
+  uint64_t next_sequence_num_;
+  uv_async_t* wakeup_;
+  // Whether |wakeup_| keeps the loop alive, only used on the loop thread.
+  bool wakeup_referenced_;
 
-  std::map<uv_timer_t*, base::OnceClosure> tasks_;
+  std::priority_queue<PendingTask> delayed_tasks_;
+  uv_timer_t* timer_;
 
   DISALLOW_COPY_AND_ASSIGN(UvTaskRunner);
 };
@@ -4,6 +4,7 @@
 
 #include "atom/browser/api/atom_api_app.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <utility>
@@ -37,8 +38,10 @@
 #include "base/path_service.h"
 #include "base/strings/string_util.h"
 #include "brave/browser/brave_content_browser_client.h"
+#include "brave/common/workers/v8_worker_pool.h"
 #include "brave/common/workers/v8_worker_thread.h"
 #include "brave/common/workers/worker_bindings.h"
+#include "brave/common/workers/worker_message.h"
 #include "chrome/common/chrome_paths.h"
 #include "components/component_updater/component_updater_paths.h"
 #include "content/browser/plugin_service_impl.h"
@@ -800,8 +803,18 @@ void App::SendMemoryPressureAlert() {
 void App::PostMessage(int worker_id,
                       v8::Local<v8::Value> message,
                       mate::Arguments* args) {
-  if (!brave::WorkerBindings::OnMessage(isolate(), worker_id, message))
-    args->ThrowError("Eror serializing message");
+  v8::Local<v8::Value> transfer_list;
+  args->GetNext(&transfer_list);
+
+  std::unique_ptr<brave::WorkerMessage> worker_message(
+      new brave::WorkerMessage);
+  std::string error;
+  if (!worker_message->Serialize(isolate(), isolate()->GetCurrentContext(),
+                                 message, transfer_list, &error)) {
+    args->ThrowError(error);
+    return;
+  }
+  brave::WorkerBindings::OnMessage(worker_id, std::move(worker_message));
 }
 
 void App::StopWorker(mate::Arguments* args) {
@@ -826,6 +839,13 @@ void App::StartWorker(mate::Arguments* args) {
   std::string worker_name = module_name + "_worker";
   args->GetNext(&worker_name);
 
+  auto warm_worker = brave::V8WorkerThread::TakeWarmWorker();
+  if (warm_worker) {
+    warm_worker->StartModule(module_name, 0, worker_name);
+    args->Return(static_cast<int>(warm_worker->GetThreadId()));
+    return;
+  }
+
   auto worker = new brave::V8WorkerThread(worker_name, module_name, this);
   int worker_id = -1;
   if (worker->Start())
@@ -833,6 +853,44 @@ void App::StartWorker(mate::Arguments* args) {
   args->Return(worker_id);
 }
 
+void App::SetWarmWorkerEnabled(bool enabled) {
+  brave::V8WorkerThread::SetWarmWorkerEnabled(this, enabled);
+}
+
+int App::StartPooledWorker(const std::string& module_name) {
+  return brave::V8WorkerPool::GetInstance(this)->StartJob(module_name);
+}
+
+void App::StopPooledWorker(int job_id) {
+  brave::V8WorkerPool::GetInstance(this)->StopJob(job_id);
+}
+
+void App::PostPooledMessage(int job_id,
+                            v8::Local<v8::Value> message,
+                            mate::Arguments* args) {
+  v8::Local<v8::Value> transfer_list;
+  args->GetNext(&transfer_list);
+
+  std::string error;
+  if (!brave::V8WorkerPool::GetInstance(this)->PostMessage(
+          isolate(), job_id, message, transfer_list, &error))
+    args->ThrowError(error);
+}
+
+void App::SetWorkerPoolOptions(const mate::Dictionary& options) {
+  brave::V8WorkerPool* pool = brave::V8WorkerPool::GetInstance(this);
+  int max_workers = static_cast<int>(pool->max_workers());
+  double idle_timeout = pool->idle_timeout().InMillisecondsF();
+  options.Get("maxWorkers", &max_workers);
+  options.Get("idleTimeout", &idle_timeout);
+  pool->SetOptions(std::max(max_workers, 1),
+                   base::TimeDelta::FromMillisecondsD(idle_timeout));
+}
+
+v8::Local<v8::Value> App::GetWorkerPoolStats() {
+  return brave::V8WorkerPool::GetInstance(this)->GetStats(isolate());
+}
+
 #if defined(OS_WIN)
 v8::Local<v8::Value> App::GetJumpListSettings() {
   JumpList jump_list(atom::Browser::Get()->GetAppUserModelID());
@@ -963,6 +1021,12 @@ void App::BuildPrototype(
       .SetMethod("_postMessage", &App::PostMessage)
       .SetMethod("_startWorker", &App::StartWorker)
       .SetMethod("stopWorker", &App::StopWorker)
+      .SetMethod("setWarmWorkerEnabled", &App::SetWarmWorkerEnabled)
+      .SetMethod("_startPooledWorker", &App::StartPooledWorker)
+      .SetMethod("_postPooledMessage", &App::PostPooledMessage)
+      .SetMethod("stopPooledWorker", &App::StopPooledWorker)
+      .SetMethod("setWorkerPoolOptions", &App::SetWorkerPoolOptions)
+      .SetMethod("getWorkerPoolStats", &App::GetWorkerPoolStats)
       .SetMethod("disableHardwareAcceleration",
                  &App::DisableHardwareAcceleration);
 }
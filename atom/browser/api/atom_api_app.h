@@ -26,6 +26,7 @@ class FilePath;
 
 namespace mate {
 class Arguments;
+class Dictionary;
 }  // namespace mate
 
 namespace atom {
@@ -131,6 +132,14 @@ class App : public AtomBrowserClient::Delegate,
                   mate::Arguments* args);
   void StartWorker(mate::Arguments* args);
   void StopWorker(mate::Arguments* args);
+  void SetWarmWorkerEnabled(bool enabled);
+  int StartPooledWorker(const std::string& module_name);
+  void StopPooledWorker(int job_id);
+  void PostPooledMessage(int job_id,
+                         v8::Local<v8::Value> message,
+                         mate::Arguments* args);
+  void SetWorkerPoolOptions(const mate::Dictionary& options);
+  v8::Local<v8::Value> GetWorkerPoolStats();
 
 #if defined(OS_WIN)
   // Get the current Jump List settings.
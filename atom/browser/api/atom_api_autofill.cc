@@ -4,6 +4,9 @@
 
 #include "atom/browser/api/atom_api_autofill.h"
 
+#include <algorithm>
+#include <map>
+#include <tuple>
 #include <vector>
 
 #include "atom/browser/autofill/personal_data_manager_factory.h"
@@ -15,6 +18,7 @@
 #include "atom/common/node_includes.h"
 #include "base/guid.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/threading/thread_task_runner_handle.h"
 #include "base/values.h"
 #include "brave/browser/brave_content_browser_client.h"
 #include "chrome/browser/password_manager/password_store_factory.h"
@@ -191,12 +195,141 @@ struct Converter<autofill::PasswordForm> {
   }
 };
 
+template<>
+struct Converter<password_manager::PasswordStoreChange> {
+  static v8::Local<v8::Value> ToV8(
+    v8::Isolate* isolate, const password_manager::PasswordStoreChange& val) {
+    mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+    switch (val.type()) {
+      case password_manager::PasswordStoreChange::ADD:
+        dict.Set("type", "add");
+        break;
+      case password_manager::PasswordStoreChange::UPDATE:
+        dict.Set("type", "update");
+        break;
+      case password_manager::PasswordStoreChange::REMOVE:
+        dict.Set("type", "remove");
+        break;
+    }
+    dict.Set("form", val.form());
+    return dict.GetHandle();
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
 
 namespace api {
 
+namespace {
+
+using LoginQueryCallback = base::Callback<void(
+    std::vector<std::unique_ptr<autofill::PasswordForm>>, int)>;
+
+struct LoginQueryOptions {
+  LoginQueryOptions() : blacklisted(false), offset(0), limit(-1) {}
+
+  // Only the logins of |origin| when it is valid.
+  GURL origin;
+  bool blacklisted;
+  int offset;
+  // No limit when negative.
+  int limit;
+};
+
+// Answers one GetLogins query and deletes itself, only the requested page is
+// converted to JS.
+class LoginQuery : public password_manager::PasswordStoreConsumer {
+ public:
+  LoginQuery(const LoginQueryOptions& options,
+             const LoginQueryCallback& callback)
+      : options_(options), callback_(callback) {}
+
+  void OnGetPasswordStoreResults(
+      std::vector<std::unique_ptr<autofill::PasswordForm>> results) override {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    // Lookups by origin also return public suffix and federated matches, and
+    // both kinds of logins.
+    std::string signon_realm = options_.origin.is_valid() ?
+        options_.origin.GetOrigin().spec() : std::string();
+    results.erase(
+        std::remove_if(
+            results.begin(), results.end(),
+            [&](const std::unique_ptr<autofill::PasswordForm>& form) {
+              return form->blacklisted_by_user != options_.blacklisted ||
+                  (!signon_realm.empty() &&
+                   form->signon_realm != signon_realm);
+            }),
+        results.end());
+
+    // Pages are only stable with a stable order.
+    std::sort(results.begin(), results.end(),
+              [](const std::unique_ptr<autofill::PasswordForm>& a,
+                 const std::unique_ptr<autofill::PasswordForm>& b) {
+                return std::tie(a->signon_realm, a->username_value) <
+                    std::tie(b->signon_realm, b->username_value);
+              });
+
+    int total = static_cast<int>(results.size());
+    int begin = std::min(options_.offset, total);
+    int end = options_.limit < 0 ? total :
+        std::min(total, begin + options_.limit);
+    std::vector<std::unique_ptr<autofill::PasswordForm>> page(
+        std::make_move_iterator(results.begin() + begin),
+        std::make_move_iterator(results.begin() + end));
+    callback_.Run(std::move(page), total);
+
+    base::ThreadTaskRunnerHandle::Get()->DeleteSoon(FROM_HERE, this);
+  }
+
+ private:
+  LoginQueryOptions options_;
+  LoginQueryCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoginQuery);
+};
+
+// Stores the modification dates of |models| in |dates|.
+template<typename T>
+void RecordModelDates(const std::vector<T*>& models,
+                      std::map<std::string, base::Time>* dates) {
+  dates->clear();
+  for (const T* model : models)
+    (*dates)[model->guid()] = model->modification_date();
+}
+
+// Compares |models| with the modification dates in |dates|, which are then
+// updated, and returns the GUIDs that were added, updated or removed.
+template<typename T>
+mate::Dictionary DiffModels(v8::Isolate* isolate,
+                            const std::vector<T*>& models,
+                            std::map<std::string, base::Time>* dates) {
+  std::vector<std::string> added, updated, removed;
+  std::map<std::string, base::Time> new_dates;
+  for (const T* model : models) {
+    auto it = dates->find(model->guid());
+    if (it == dates->end())
+      added.push_back(model->guid());
+    else if (it->second != model->modification_date())
+      updated.push_back(model->guid());
+    new_dates[model->guid()] = model->modification_date();
+  }
+  for (const auto& it : *dates) {
+    if (!new_dates.count(it.first))
+      removed.push_back(it.first);
+  }
+  dates->swap(new_dates);
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("added", added);
+  dict.Set("updated", updated);
+  dict.Set("removed", removed);
+  return dict;
+}
+
+}  // namespace
+
 Autofill::Autofill(v8::Isolate* isolate,
                  content::BrowserContext* browser_context)
       : browser_context_(browser_context),
@@ -205,8 +338,16 @@ Autofill::Autofill(v8::Isolate* isolate,
   personal_data_manager_ =
       autofill::PersonalDataManagerFactory::GetForBrowserContext(
       browser_context_);
-  if (personal_data_manager_)
+  if (personal_data_manager_) {
     personal_data_manager_->AddObserver(this);
+    // Deltas are relative to the data that is already loaded.
+    if (personal_data_manager_->IsDataLoaded()) {
+      RecordModelDates(personal_data_manager_->GetProfiles(),
+                       &profile_dates_);
+      RecordModelDates(personal_data_manager_->GetCreditCards(),
+                       &credit_card_dates_);
+    }
+  }
   password_manager::PasswordStore* store = GetPasswordStore();
   if (store)
     store->AddObserver(this);
@@ -503,6 +644,45 @@ void Autofill::GetBlacklistLogins(mate::Arguments* args) {
   }
 }
 
+void Autofill::GetLogins(mate::Arguments* args) {
+  LoginQueryOptions options;
+  mate::Dictionary dict;
+  if (args->GetNext(&dict)) {
+    dict.Get("origin", &options.origin);
+    dict.Get("blacklisted", &options.blacklisted);
+    dict.Get("offset", &options.offset);
+    dict.Get("limit", &options.limit);
+    if (options.offset < 0) {
+      args->ThrowError("`offset` must not be negative");
+      return;
+    }
+  }
+
+  LoginQueryCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("`callback` is a required field");
+    return;
+  }
+
+  password_manager::PasswordStore* store = GetPasswordStore();
+  if (!store)
+    return;
+
+  LoginQuery* query = new LoginQuery(options, callback);
+  if (options.origin.is_valid()) {
+    // Served by the signon realm index of the login database.
+    password_manager::PasswordStore::FormDigest digest(
+        autofill::PasswordForm::SCHEME_HTML,
+        options.origin.GetOrigin().spec(),
+        options.origin);
+    store->GetLogins(digest, query);
+  } else if (options.blacklisted) {
+    store->GetBlacklistLogins(query);
+  } else {
+    store->GetAutofillableLogins(query);
+  }
+}
+
 void Autofill::AddLogin(mate::Arguments* args) {
   autofill::PasswordForm form;
   if (args->Length() == 1 && !args->GetNext(&form)) {
@@ -565,9 +745,20 @@ void Autofill::OnPersonalDataChanged() {
                   "personal-data-changed",
                   profile_guids,
                   credit_card_guids);
+
+  v8::Locker locker(isolate());
+  v8::HandleScope handle_scope(isolate());
+  Emit("personal-data-changed",
+       DiffModels(isolate(), profiles, &profile_dates_),
+       DiffModels(isolate(), credit_cards, &credit_card_dates_));
 }
+
 void Autofill::OnLoginsChanged(
     const password_manager::PasswordStoreChangeList& changes) {
+  Emit("logins-changed", changes);
+
+  // Callers of getAutofillableLogins and getBlackedlistLogins expect their
+  // callbacks to be run again with all the logins.
   password_manager::PasswordStore* store = GetPasswordStore();
   if (store) {
     BravePasswordStoreConsumer* password_list_consumer =
@@ -603,6 +794,7 @@ void Autofill::BuildPrototype(v8::Isolate* isolate,
     .SetMethod("clearAutofillData", &Autofill::ClearAutofillData)
     .SetMethod("getAutofillableLogins", &Autofill::GetAutofillableLogins)
     .SetMethod("getBlackedlistLogins", &Autofill::GetBlacklistLogins)
+    .SetMethod("getLogins", &Autofill::GetLogins)
     .SetMethod("addLogin", &Autofill::AddLogin)
     .SetMethod("updateLogin", &Autofill::UpdateLogin)
     .SetMethod("removeLogin", &Autofill::RemoveLogin)
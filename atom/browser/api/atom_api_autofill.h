@@ -5,6 +5,7 @@
 #ifndef ATOM_BROWSER_API_ATOM_API_AUTOFILL_H_
 #define ATOM_BROWSER_API_ATOM_API_AUTOFILL_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -12,6 +13,7 @@
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
+#include "base/time/time.h"
 #include "brave/browser/brave_browser_context.h"
 #include "components/autofill/core/browser/personal_data_manager_observer.h"
 #include "components/password_manager/core/browser/password_store.h"
@@ -84,6 +86,9 @@ class Autofill : public mate::TrackableObject<Autofill>,
 
   void GetAutofillableLogins(mate::Arguments* args);
   void GetBlacklistLogins(mate::Arguments* args);
+  // Queries one page of logins, optionally only those of an origin. Unlike
+  // the two methods above the callback is only run once.
+  void GetLogins(mate::Arguments* args);
 
   void AddLogin(mate::Arguments* args);
   void UpdateLogin(mate::Arguments* args);
@@ -108,6 +113,11 @@ class Autofill : public mate::TrackableObject<Autofill>,
 
   autofill::PersonalDataManager* personal_data_manager_;  // not owned
 
+  // Modification dates of the profiles and credit cards by GUID, as of the
+  // last OnPersonalDataChanged, used to report what changed since.
+  std::map<std::string, base::Time> profile_dates_;
+  std::map<std::string, base::Time> credit_card_dates_;
+
   base::WeakPtrFactory<Autofill> weak_ptr_factory_;
 
   std::unique_ptr<BravePasswordStoreConsumer> password_list_consumer_;
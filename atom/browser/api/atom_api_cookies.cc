@@ -3,13 +3,17 @@
 // found in the LICENSE file.
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "atom/browser/api/atom_api_cookies.h"
 
 #include "atom/browser/atom_browser_context.h"
+#include "atom/browser/net/cookie_index.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/optional.h"
 #include "base/time/time.h"
 #include "base/values.h"
 #include "content/public/browser/browser_context.h"
@@ -56,6 +60,28 @@ struct Converter<net::CanonicalCookie> {
   }
 };
 
+template<>
+struct Converter<net::CookieStore::ChangeCause> {
+  static v8::Local<v8::Value> ToV8(v8::Isolate* isolate,
+                                   const net::CookieStore::ChangeCause& val) {
+    switch (val) {
+      case net::CookieStore::ChangeCause::INSERTED:
+      case net::CookieStore::ChangeCause::EXPLICIT:
+        return mate::StringToV8(isolate, "explicit");
+      case net::CookieStore::ChangeCause::OVERWRITE:
+        return mate::StringToV8(isolate, "overwrite");
+      case net::CookieStore::ChangeCause::EXPIRED:
+        return mate::StringToV8(isolate, "expired");
+      case net::CookieStore::ChangeCause::EVICTED:
+        return mate::StringToV8(isolate, "evicted");
+      case net::CookieStore::ChangeCause::EXPIRED_OVERWRITE:
+        return mate::StringToV8(isolate, "expired-overwrite");
+      default:
+        return mate::StringToV8(isolate, "unknown");
+    }
+  }
+};
+
 }  // namespace mate
 
 namespace atom {
@@ -85,23 +111,48 @@ bool MatchesDomain(std::string filter, const std::string& domain) {
   return false;
 }
 
-// Returns whether |cookie| matches |filter|.
-bool MatchesCookie(const base::DictionaryValue* filter,
-                   const net::CanonicalCookie& cookie) {
-  std::string str;
-  bool b;
-  if (filter->GetString("name", &str) && str != cookie.Name())
-    return false;
-  if (filter->GetString("path", &str) && str != cookie.Path())
-    return false;
-  if (filter->GetString("domain", &str) && !MatchesDomain(str, cookie.Domain()))
-    return false;
-  if (filter->GetBoolean("secure", &b) && b != cookie.IsSecure())
-    return false;
-  if (filter->GetBoolean("session", &b) && b != !cookie.IsPersistent())
-    return false;
-  return true;
-}
+// Filter of the cookie queries, read once from the filter object.
+struct CookieFilter {
+  explicit CookieFilter(const base::DictionaryValue& filter) {
+    std::string str;
+    bool b;
+    filter.GetString("url", &url);
+    if (filter.GetString("name", &str))
+      name = str;
+    if (filter.GetString("path", &str))
+      path = str;
+    if (filter.GetString("domain", &str))
+      domain = str;
+    if (filter.GetBoolean("secure", &b))
+      secure = b;
+    if (filter.GetBoolean("session", &b))
+      session = b;
+  }
+
+  // Returns whether |cookie| matches the filter.
+  bool Matches(const net::CanonicalCookie& cookie) const {
+    if (name && *name != cookie.Name())
+      return false;
+    if (path && *path != cookie.Path())
+      return false;
+    if (domain && !MatchesDomain(*domain, cookie.Domain()))
+      return false;
+    if (secure && *secure != cookie.IsSecure())
+      return false;
+    if (session && *session != !cookie.IsPersistent())
+      return false;
+    return true;
+  }
+
+  std::string url;
+  base::Optional<std::string> name;
+  base::Optional<std::string> path;
+  base::Optional<std::string> domain;
+  base::Optional<bool> secure;
+  base::Optional<bool> session;
+};
+
+using CookieListCallback = base::Callback<void(const net::CookieList&)>;
 
 // Helper to returns the CookieStore.
 inline net::CookieStore* GetCookieStore(
@@ -115,35 +166,43 @@ void RunCallbackInUI(const base::Closure& callback) {
 }
 
 // Remove cookies from |list| not matching |filter|, and pass it to |callback|.
-void FilterCookies(std::unique_ptr<base::DictionaryValue> filter,
-                   const Cookies::GetCallback& callback,
+void FilterCookies(std::unique_ptr<CookieFilter> filter,
+                   const CookieListCallback& callback,
                    const net::CookieList& list) {
   net::CookieList result;
   for (const auto& cookie : list) {
-    if (MatchesCookie(filter.get(), cookie))
+    if (filter->Matches(cookie))
       result.push_back(cookie);
   }
-  RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, result));
+  callback.Run(result);
 }
 
-// Receives cookies matching |filter| in IO thread.
-void GetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                    std::unique_ptr<base::DictionaryValue> filter,
-                    const Cookies::GetCallback& callback) {
-  std::string url;
-  filter->GetString("url", &url);
-
+// Receives cookies matching |filter| in IO thread. Queries without an url
+// are served by |index|, which only reads the cookies stored under the
+// filter's domain when it has one.
+void QueryCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                      scoped_refptr<CookieIndex> index,
+                      std::unique_ptr<CookieFilter> filter,
+                      const CookieListCallback& callback) {
+  std::string url = filter->url;
+  std::string domain = filter->domain.value_or(std::string());
   auto filtered_callback =
       base::Bind(FilterCookies, base::Passed(&filter), callback);
 
   // Empty url will match all url cookies.
   if (url.empty())
-    GetCookieStore(getter)->GetAllCookiesAsync(filtered_callback);
+    index->Query(domain, filtered_callback);
   else
     GetCookieStore(getter)->GetAllCookiesForURLAsync(GURL(url),
         filtered_callback);
 }
 
+// Callback of QueryCookiesOnIO for Get.
+void OnGetCookies(const Cookies::GetCallback& callback,
+                  const net::CookieList& list) {
+  RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, list));
+}
+
 // Removes cookie with |url| and |name| in IO thread.
 void RemoveCookieOnIOThread(scoped_refptr<net::URLRequestContextGetter> getter,
                             const GURL& url, const std::string& name,
@@ -152,70 +211,207 @@ void RemoveCookieOnIOThread(scoped_refptr<net::URLRequestContextGetter> getter,
       url, name, base::Bind(RunCallbackInUI, callback));
 }
 
-// Callback of SetCookie.
-void OnSetCookie(const Cookies::SetCallback& callback, bool success) {
-  RunCallbackInUI(
-      base::Bind(callback, success ? Cookies::SUCCESS : Cookies::FAILED));
+// Counts the cookies deleted by RemoveCookiesOnIO, the callback runs once
+// every deletion has completed.
+class RemoveCookiesRequest : public base::RefCounted<RemoveCookiesRequest> {
+ public:
+  RemoveCookiesRequest(size_t pending,
+                       const Cookies::RemoveManyCallback& callback)
+      : pending_(pending), removed_(0), callback_(callback) {}
+
+  void OnDeleted(uint32_t num_deleted) {
+    removed_ += num_deleted;
+    if (--pending_ == 0)
+      RunCallbackInUI(base::Bind(callback_, Cookies::SUCCESS, removed_));
+  }
+
+ private:
+  friend class base::RefCounted<RemoveCookiesRequest>;
+  ~RemoveCookiesRequest() {}
+
+  size_t pending_;
+  uint32_t removed_;
+  Cookies::RemoveManyCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(RemoveCookiesRequest);
+};
+
+// Deletes the cookies in |list|, the result of a query.
+void DeleteCookies(scoped_refptr<net::URLRequestContextGetter> getter,
+                   const Cookies::RemoveManyCallback& callback,
+                   const net::CookieList& list) {
+  if (list.empty()) {
+    RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS, 0u));
+    return;
+  }
+
+  scoped_refptr<RemoveCookiesRequest> request(
+      new RemoveCookiesRequest(list.size(), callback));
+  net::CookieStore* store = GetCookieStore(getter);
+  for (const auto& cookie : list) {
+    store->DeleteCanonicalCookieAsync(
+        cookie, base::Bind(&RemoveCookiesRequest::OnDeleted, request));
+  }
 }
 
-// Sets cookie with |details| in IO thread.
-void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
-                   std::unique_ptr<base::DictionaryValue> details,
-                   const Cookies::SetCallback& callback) {
+// Creates the cookie described by |details|, returns nullptr when the
+// details are invalid.
+std::unique_ptr<net::CanonicalCookie> CreateCookie(
+    const base::DictionaryValue& details,
+    bool* secure_source,
+    bool* modify_http_only) {
   std::string url, name, value, domain, path;
   bool secure = false;
   bool http_only = false;
   double creation_date;
   double expiration_date;
   double last_access_date;
-  details->GetString("url", &url);
-  details->GetString("name", &name);
-  details->GetString("value", &value);
-  details->GetString("domain", &domain);
-  details->GetString("path", &path);
-  details->GetBoolean("secure", &secure);
-  details->GetBoolean("httpOnly", &http_only);
+  details.GetString("url", &url);
+  details.GetString("name", &name);
+  details.GetString("value", &value);
+  details.GetString("domain", &domain);
+  details.GetString("path", &path);
+  details.GetBoolean("secure", &secure);
+  details.GetBoolean("httpOnly", &http_only);
 
   base::Time creation_time;
-  if (details->GetDouble("creationDate", &creation_date)) {
+  if (details.GetDouble("creationDate", &creation_date)) {
     creation_time = (creation_date == 0) ?
         base::Time::UnixEpoch() :
         base::Time::FromDoubleT(creation_date);
   }
 
   base::Time expiration_time;
-  if (details->GetDouble("expirationDate", &expiration_date)) {
+  if (details.GetDouble("expirationDate", &expiration_date)) {
     expiration_time = (expiration_date == 0) ?
         base::Time::UnixEpoch() :
         base::Time::FromDoubleT(expiration_date);
   }
 
   base::Time last_access_time;
-  if (details->GetDouble("lastAccessDate", &last_access_date)) {
+  if (details.GetDouble("lastAccessDate", &last_access_date)) {
     last_access_time = (last_access_date == 0) ?
         base::Time::UnixEpoch() :
         base::Time::FromDoubleT(last_access_date);
   }
 
-  bool secure_source = false;
-  bool modify_http_only = false;
-  details->GetBoolean("secure_source", &secure_source);
-  details->GetBoolean("modify_http_only", &modify_http_only);
-
-  GetCookieStore(getter)->SetCanonicalCookieAsync(
-      net::CanonicalCookie::CreateSanitizedCookie(
-          GURL(url), name, value, domain, path, creation_time, expiration_time,
-          last_access_time, secure, http_only,
-          net::CookieSameSite::DEFAULT_MODE, net::COOKIE_PRIORITY_DEFAULT),
-      secure_source, modify_http_only, base::Bind(OnSetCookie, callback));
+  *secure_source = false;
+  *modify_http_only = false;
+  details.GetBoolean("secure_source", secure_source);
+  details.GetBoolean("modify_http_only", modify_http_only);
+
+  return net::CanonicalCookie::CreateSanitizedCookie(
+      GURL(url), name, value, domain, path, creation_time, expiration_time,
+      last_access_time, secure, http_only,
+      net::CookieSameSite::DEFAULT_MODE, net::COOKIE_PRIORITY_DEFAULT);
+}
+
+// Sets the cookie described by |details| and runs |callback| in IO thread
+// with whether it succeeded.
+void SetCookie(net::CookieStore* store,
+               const base::DictionaryValue& details,
+               const base::Callback<void(bool)>& callback) {
+  bool secure_source, modify_http_only;
+  std::unique_ptr<net::CanonicalCookie> cookie =
+      CreateCookie(details, &secure_source, &modify_http_only);
+  if (!cookie) {
+    callback.Run(false);
+    return;
+  }
+  store->SetCanonicalCookieAsync(std::move(cookie), secure_source,
+                                 modify_http_only, callback);
+}
+
+// Callback of SetCookie.
+void OnSetCookie(const Cookies::SetCallback& callback, bool success) {
+  RunCallbackInUI(
+      base::Bind(callback, success ? Cookies::SUCCESS : Cookies::FAILED));
+}
+
+// Sets cookie with |details| in IO thread.
+void SetCookieOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                   std::unique_ptr<base::DictionaryValue> details,
+                   const Cookies::SetCallback& callback) {
+  SetCookie(GetCookieStore(getter), *details,
+            base::Bind(OnSetCookie, callback));
+}
+
+// Collects the results of SetCookiesOnIO, the callback runs once every
+// cookie has been set.
+class SetCookiesRequest : public base::RefCounted<SetCookiesRequest> {
+ public:
+  SetCookiesRequest(size_t count, const Cookies::SetManyCallback& callback)
+      : results_(count, Cookies::FAILED),
+        pending_(count),
+        failed_(false),
+        callback_(callback) {}
+
+  void OnSet(size_t index, bool success) {
+    results_[index] = success ? Cookies::SUCCESS : Cookies::FAILED;
+    failed_ |= !success;
+    if (--pending_ == 0) {
+      RunCallbackInUI(base::Bind(
+          callback_, failed_ ? Cookies::FAILED : Cookies::SUCCESS, results_));
+    }
+  }
+
+ private:
+  friend class base::RefCounted<SetCookiesRequest>;
+  ~SetCookiesRequest() {}
+
+  std::vector<Cookies::Error> results_;
+  size_t pending_;
+  bool failed_;
+  Cookies::SetManyCallback callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(SetCookiesRequest);
+};
+
+// Sets the cookies described by |list| in IO thread.
+void SetCookiesOnIO(scoped_refptr<net::URLRequestContextGetter> getter,
+                    std::unique_ptr<base::ListValue> list,
+                    const Cookies::SetManyCallback& callback) {
+  if (list->empty()) {
+    RunCallbackInUI(base::Bind(callback, Cookies::SUCCESS,
+                               std::vector<Cookies::Error>()));
+    return;
+  }
+
+  scoped_refptr<SetCookiesRequest> request(
+      new SetCookiesRequest(list->GetSize(), callback));
+  net::CookieStore* store = GetCookieStore(getter);
+  for (size_t i = 0; i < list->GetSize(); ++i) {
+    auto on_set = base::Bind(&SetCookiesRequest::OnSet, request, i);
+    const base::DictionaryValue* details = nullptr;
+    if (list->GetDictionary(i, &details))
+      SetCookie(store, *details, on_set);
+    else
+      on_set.Run(false);
+  }
+}
+
+// Forwards the changes seen by the index to the UI thread.
+void OnCookieChangedOnIO(base::WeakPtr<Cookies> cookies,
+                         const net::CanonicalCookie& cookie,
+                         net::CookieStore::ChangeCause cause) {
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&Cookies::OnCookieChanged, cookies, cookie, cause));
 }
 
 }  // namespace
 
 Cookies::Cookies(v8::Isolate* isolate,
                  AtomBrowserContext* browser_context)
-      : request_context_getter_(browser_context->url_request_context_getter()) {
+      : request_context_getter_(browser_context->url_request_context_getter()),
+        weak_factory_(this) {
   Init(isolate);
+  cookie_index_ = new CookieIndex(
+      request_context_getter_,
+      base::Bind(OnCookieChangedOnIO, weak_factory_.GetWeakPtr()));
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&CookieIndex::Start, cookie_index_));
 }
 
 Cookies::~Cookies() {
@@ -234,11 +430,12 @@ void Cookies::GetAll(const base::DictionaryValue& filter,
 
 void Cookies::Get(const base::DictionaryValue& filter,
                   const GetCallback& callback) {
-  std::unique_ptr<base::DictionaryValue> copied(filter.CreateDeepCopy());
+  std::unique_ptr<CookieFilter> parsed(new CookieFilter(filter));
   auto getter = base::RetainedRef(request_context_getter_);
   content::BrowserThread::PostTask(
       BrowserThread::IO, FROM_HERE,
-      base::Bind(GetCookiesOnIO, getter, Passed(&copied), callback));
+      base::Bind(QueryCookiesOnIO, getter, cookie_index_, Passed(&parsed),
+                 base::Bind(OnGetCookies, callback)));
 }
 
 void Cookies::Remove(const GURL& url, const std::string& name,
@@ -258,6 +455,42 @@ void Cookies::Set(const base::DictionaryValue& details,
       base::Bind(SetCookieOnIO, getter, Passed(&copied), callback));
 }
 
+void Cookies::RemoveMany(const base::DictionaryValue& filter,
+                         const RemoveManyCallback& callback) {
+  std::unique_ptr<CookieFilter> parsed(new CookieFilter(filter));
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(QueryCookiesOnIO, getter, cookie_index_, Passed(&parsed),
+                 base::Bind(DeleteCookies, getter, callback)));
+}
+
+void Cookies::SetMany(const base::ListValue& list,
+                      const SetManyCallback& callback) {
+  std::unique_ptr<base::ListValue> copied(list.CreateDeepCopy());
+  auto getter = base::RetainedRef(request_context_getter_);
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(SetCookiesOnIO, getter, Passed(&copied), callback));
+}
+
+void Cookies::SetEventListened(const std::string& name, bool listened) {
+  mate::TrackableObject<Cookies>::SetEventListened(name, listened);
+  if (name != "changed")
+    return;
+
+  content::BrowserThread::PostTask(
+      BrowserThread::IO, FROM_HERE,
+      base::Bind(&CookieIndex::SetNotifyChanges, cookie_index_,
+                 HasListeners(name)));
+}
+
+void Cookies::OnCookieChanged(const net::CanonicalCookie& cookie,
+                              net::CookieStore::ChangeCause cause) {
+  Emit("changed", cookie, cause,
+       cause != net::CookieStore::ChangeCause::INSERTED);
+}
+
 // static
 mate::Handle<Cookies> Cookies::Create(
     v8::Isolate* isolate,
@@ -273,7 +506,10 @@ void Cookies::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("get", &Cookies::Get)
       .SetMethod("remove", &Cookies::Remove)
       .SetMethod("set", &Cookies::Set)
-      .SetMethod("getAll", &Cookies::GetAll);
+      .SetMethod("getAll", &Cookies::GetAll)
+      .SetMethod("removeMany", &Cookies::RemoveMany)
+      .SetMethod("setMany", &Cookies::SetMany)
+      .SetMethod("_setEventListened", &Cookies::SetEventListened);
 }
 
 }  // namespace api
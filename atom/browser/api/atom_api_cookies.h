@@ -6,14 +6,19 @@
 #define ATOM_BROWSER_API_ATOM_API_COOKIES_H_
 
 #include <string>
+#include <vector>
 
 #include "atom/browser/api/trackable_object.h"
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
 #include "native_mate/handle.h"
 #include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_store.h"
 
 namespace base {
 class DictionaryValue;
+class ListValue;
 }
 
 namespace net {
@@ -23,6 +28,7 @@ class URLRequestContextGetter;
 namespace atom {
 
 class AtomBrowserContext;
+class CookieIndex;
 
 namespace api {
 
@@ -35,6 +41,9 @@ class Cookies : public mate::TrackableObject<Cookies> {
 
   using GetCallback = base::Callback<void(Error, const net::CookieList&)>;
   using SetCallback = base::Callback<void(Error)>;
+  using SetManyCallback =
+      base::Callback<void(Error, const std::vector<Error>&)>;
+  using RemoveManyCallback = base::Callback<void(Error, uint32_t)>;
 
   static mate::Handle<Cookies> Create(v8::Isolate* isolate,
                                       AtomBrowserContext* browser_context);
@@ -43,6 +52,15 @@ class Cookies : public mate::TrackableObject<Cookies> {
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
+  // Emits the "changed" event, called for every change of the cookie store
+  // while JS listens to it.
+  void OnCookieChanged(const net::CanonicalCookie& cookie,
+                       net::CookieStore::ChangeCause cause);
+
+  // Hides mate::EventEmitter::SetEventListened, changes are only sent from
+  // the IO thread while "changed" has listeners.
+  void SetEventListened(const std::string& name, bool listened);
+
  protected:
   Cookies(v8::Isolate* isolate, AtomBrowserContext* browser_context);
   ~Cookies() override;
@@ -52,9 +70,17 @@ class Cookies : public mate::TrackableObject<Cookies> {
   void Remove(const GURL& url, const std::string& name,
               const base::Closure& callback);
   void Set(const base::DictionaryValue& details, const SetCallback& callback);
+  // Removes all the cookies matching |filter|.
+  void RemoveMany(const base::DictionaryValue& filter,
+                  const RemoveManyCallback& callback);
+  // Sets every cookie of |list| in a single IO thread task.
+  void SetMany(const base::ListValue& list, const SetManyCallback& callback);
 
  private:
   net::URLRequestContextGetter* request_context_getter_;
+  scoped_refptr<CookieIndex> cookie_index_;
+
+  base::WeakPtrFactory<Cookies> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Cookies);
 };
@@ -9,12 +9,14 @@
 #include "atom/browser/browser.h"
 #include "atom/browser/net/url_request_buffer_job.h"
 #include "atom/browser/net/url_request_fetch_job.h"
+#include "atom/browser/net/url_request_stream_job.h"
 #include "atom/browser/net/url_request_string_job.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/v8_value_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
 #include "atom/common/node_includes.h"
 #include "atom/common/options_switches.h"
+#include "base/bind_helpers.h"
 #include "base/command_line.h"
 #include "base/strings/string_util.h"
 #include "chrome/browser/custom_handlers/protocol_handler_registry.h"
@@ -75,6 +77,7 @@ Protocol::Protocol(v8::Isolate* isolate, Profile* profile)
     : profile_(profile),
       request_context_getter_(static_cast<brightray::URLRequestContextGetter*>(
           profile->GetRequestContext())),
+      response_cache_(new ProtocolResponseCache),
       weak_factory_(this) {
   Init(isolate);
 }
@@ -97,7 +100,7 @@ void Protocol::RegisterProtocol(const std::string& scheme,
   content::BrowserThread::PostTaskAndReplyWithResult(
       content::BrowserThread::IO, FROM_HERE,
       base::Bind(&Protocol::RegisterProtocolInIO<RequestJob>,
-          request_context_getter_,
+          request_context_getter_, response_cache_,
           isolate(), scheme, handler),
       base::Bind(&Protocol::OnIOCompleted,
                  GetWeakPtr(), callback));
@@ -107,6 +110,7 @@ void Protocol::RegisterProtocol(const std::string& scheme,
 template<typename RequestJob>
 Protocol::ProtocolError Protocol::RegisterProtocolInIO(
     scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+    scoped_refptr<ProtocolResponseCache> response_cache,
     v8::Isolate* isolate,
     const std::string& scheme,
     const Handler& handler) {
@@ -116,7 +120,8 @@ Protocol::ProtocolError Protocol::RegisterProtocolInIO(
     return PROTOCOL_REGISTERED;
   std::unique_ptr<CustomProtocolHandler<RequestJob>> protocol_handler(
       new CustomProtocolHandler<RequestJob>(
-          isolate, request_context_getter.get(), handler));
+          isolate, request_context_getter.get(), handler,
+          response_cache.get()));
   if (job_factory->SetProtocolHandler(scheme, std::move(protocol_handler)))
     return PROTOCOL_OK;
   else
@@ -130,7 +135,7 @@ void Protocol::UnregisterProtocol(
   content::BrowserThread::PostTaskAndReplyWithResult(
       content::BrowserThread::IO, FROM_HERE,
       base::Bind(&Protocol::UnregisterProtocolInIO,
-          request_context_getter_, scheme),
+          request_context_getter_, response_cache_, scheme),
       base::Bind(&Protocol::OnIOCompleted,
                  GetWeakPtr(), callback));
 }
@@ -138,12 +143,14 @@ void Protocol::UnregisterProtocol(
 // static
 Protocol::ProtocolError Protocol::UnregisterProtocolInIO(
     scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+    scoped_refptr<ProtocolResponseCache> response_cache,
     const std::string& scheme) {
   auto job_factory = static_cast<net::URLRequestJobFactoryImpl*>(
       request_context_getter->job_factory());
   if (!job_factory->IsHandledProtocol(scheme))
     return PROTOCOL_NOT_REGISTERED;
   job_factory->SetProtocolHandler(scheme, nullptr);
+  response_cache->Clear(scheme);
   return PROTOCOL_OK;
 }
 
@@ -163,6 +170,35 @@ bool Protocol::IsProtocolHandledInIO(
   return request_context_getter->job_factory()->IsHandledProtocol(scheme);
 }
 
+void Protocol::GetResponseCacheStats(const StatsCallback& callback) {
+  content::BrowserThread::PostTaskAndReplyWithResult(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&ProtocolResponseCache::GetStats, response_cache_),
+      base::Bind(&Protocol::OnGetResponseCacheStats,
+                 GetWeakPtr(), callback));
+}
+
+void Protocol::OnGetResponseCacheStats(
+    const StatsCallback& callback,
+    const ProtocolResponseCache::Stats& stats) {
+  base::DictionaryValue dict;
+  dict.SetDouble("hits", stats.hits);
+  dict.SetDouble("misses", stats.misses);
+  dict.SetInteger("entries", static_cast<int>(stats.entries));
+  dict.SetDouble("size", stats.size);
+  callback.Run(dict);
+}
+
+void Protocol::ClearResponseCache(mate::Arguments* args) {
+  base::Closure callback;
+  args->GetNext(&callback);
+  content::BrowserThread::PostTaskAndReply(
+      content::BrowserThread::IO, FROM_HERE,
+      base::Bind(&ProtocolResponseCache::Clear, response_cache_,
+                 std::string()),
+      callback.is_null() ? base::Bind(&base::DoNothing) : callback);
+}
+
 const base::ListValue*
 Protocol::GetNavigatorHandlers() {
   ProtocolHandlerRegistry* registry =
@@ -259,10 +295,14 @@ void Protocol::BuildPrototype(
                  &Protocol::RegisterProtocol<URLRequestStringJob>)
       .SetMethod("registerBufferProtocol",
                  &Protocol::RegisterProtocol<URLRequestBufferJob>)
+      .SetMethod("registerStreamProtocol",
+                 &Protocol::RegisterProtocol<URLRequestStreamJob>)
       .SetMethod("registerHttpProtocol",
                  &Protocol::RegisterProtocol<URLRequestFetchJob>)
       .SetMethod("unregisterProtocol", &Protocol::UnregisterProtocol)
       .SetMethod("isProtocolHandled", &Protocol::IsProtocolHandled)
+      .SetMethod("getResponseCacheStats", &Protocol::GetResponseCacheStats)
+      .SetMethod("clearResponseCache", &Protocol::ClearResponseCache)
       .SetMethod("isNavigatorProtocolHandled",
                  &Protocol::IsNavigatorProtocolHandled)
       .SetMethod("getNavigatorHandlers",
@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "atom/browser/api/trackable_object.h"
+#include "atom/browser/net/protocol_response_cache.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "chrome/common/custom_handlers/protocol_handler.h"
@@ -53,6 +54,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
       base::Callback<void(const base::DictionaryValue&, v8::Local<v8::Value>)>;
   using CompletionCallback = base::Callback<void(v8::Local<v8::Value>)>;
   using BooleanCallback = base::Callback<void(bool)>;
+  using StatsCallback = base::Callback<void(const base::DictionaryValue&)>;
 
   static mate::Handle<Protocol> Create(
       v8::Isolate* isolate, content::BrowserContext* browser_context);
@@ -84,17 +86,26 @@ class Protocol : public mate::TrackableObject<Protocol> {
     CustomProtocolHandler(
         v8::Isolate* isolate,
         net::URLRequestContextGetter* request_context,
-        const Handler& handler)
+        const Handler& handler,
+        ProtocolResponseCache* response_cache)
         : isolate_(isolate),
           request_context_(request_context),
-          handler_(handler) {}
+          handler_(handler),
+          response_cache_(response_cache) {}
     ~CustomProtocolHandler() override {}
 
     net::URLRequestJob* MaybeCreateJob(
         net::URLRequest* request,
         net::NetworkDelegate* network_delegate) const override {
+      // Cached responses are served without a round trip to the handler.
+      net::URLRequestJob* cached_job =
+          response_cache_->MaybeCreateJob(request, network_delegate);
+      if (cached_job)
+        return cached_job;
+
       RequestJob* request_job = new RequestJob(request, network_delegate);
-      request_job->SetHandlerInfo(isolate_, request_context_.get(), handler_);
+      request_job->SetHandlerInfo(isolate_, request_context_.get(), handler_,
+                                  response_cache_.get());
       return request_job;
     }
 
@@ -102,6 +113,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
     v8::Isolate* isolate_;
     scoped_refptr<net::URLRequestContextGetter> request_context_;
     Protocol::Handler handler_;
+    scoped_refptr<ProtocolResponseCache> response_cache_;
 
     DISALLOW_COPY_AND_ASSIGN(CustomProtocolHandler);
   };
@@ -118,6 +130,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
   template<typename RequestJob>
   static ProtocolError RegisterProtocolInIO(
       scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+      scoped_refptr<ProtocolResponseCache> response_cache,
       v8::Isolate* isolate,
       const std::string& scheme,
       const Handler& handler);
@@ -126,6 +139,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
   void UnregisterProtocol(const std::string& scheme, mate::Arguments* args);
   static ProtocolError UnregisterProtocolInIO(
       scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
+      scoped_refptr<ProtocolResponseCache> response_cache,
       const std::string& scheme);
 
   // Whether the protocol has handler registered.
@@ -135,6 +149,14 @@ class Protocol : public mate::TrackableObject<Protocol> {
       scoped_refptr<brightray::URLRequestContextGetter> request_context_getter,
       const std::string& scheme);
 
+  // Hit/miss statistics of the response cache of JS protocol handlers.
+  void GetResponseCacheStats(const StatsCallback& callback);
+  void OnGetResponseCacheStats(const StatsCallback& callback,
+                               const ProtocolResponseCache::Stats& stats);
+
+  // Drop the cached responses of all JS protocol handlers.
+  void ClearResponseCache(mate::Arguments* args);
+
   const base::ListValue* GetNavigatorHandlers();
   void UnregisterNavigatorHandler(const std::string& scheme,
       const std::string& spec);
@@ -154,6 +176,7 @@ class Protocol : public mate::TrackableObject<Protocol> {
 
   Profile* profile_;  // not owned
   scoped_refptr<brightray::URLRequestContextGetter> request_context_getter_;
+  scoped_refptr<ProtocolResponseCache> response_cache_;
   base::WeakPtrFactory<Protocol> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Protocol);
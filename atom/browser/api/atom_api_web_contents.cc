@@ -23,6 +23,7 @@
 #include "atom/browser/lib/bluetooth_chooser.h"
 #include "atom/browser/native_window.h"
 #include "atom/browser/net/atom_network_delegate.h"
+#include "atom/browser/thumbnail_tab_helper.h"
 #include "atom/browser/ui/drag_util.h"
 #include "atom/browser/web_contents_permission_helper.h"
 #include "atom/browser/web_contents_preferences.h"
@@ -397,6 +398,9 @@ struct FrameDispatchHelper {
 
 namespace {
 
+// Coalesced events are emitted about once per frame by default.
+const int kDefaultCoalescingIntervalMs = 16;
+
 mate::Handle<api::Session> SessionFromOptions(v8::Isolate* isolate,
     const mate::Dictionary& options) {
   mate::Handle<api::Session> session;
@@ -441,6 +445,24 @@ void OnCapturePageDone(base::Callback<void(const gfx::Image&)> callback,
   callback.Run(gfx::Image::CreateFrom1xBitmap(bitmap));
 }
 
+// Called when CaptureThumbnail is done.
+void OnCaptureThumbnailDone(
+    v8::Isolate* isolate,
+    const base::Callback<void(v8::Local<v8::Value>)>& callback,
+    const ThumbnailTabHelper::Thumbnail& thumbnail) {
+  v8::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  if (!thumbnail.id) {
+    callback.Run(v8::Null(isolate));
+    return;
+  }
+  mate::Dictionary handle = mate::Dictionary::CreateEmpty(isolate);
+  handle.Set("id", thumbnail.id);
+  handle.Set("size", thumbnail.size);
+  handle.Set("capturedAt", thumbnail.captured_at.ToJsTime());
+  callback.Run(handle.GetHandle());
+}
+
 }  // namespace
 
 WebContents::WebContents(v8::Isolate* isolate,
@@ -452,6 +474,9 @@ WebContents::WebContents(v8::Isolate* isolate,
       enable_devtools_(true),
       is_being_destroyed_(false),
       guest_delegate_(nullptr),
+      coalesce_events_(false),
+      coalescing_interval_(base::TimeDelta::FromMilliseconds(
+          kDefaultCoalescingIntervalMs)),
       weak_ptr_factory_(this) {
   if (type == REMOTE) {
     guest_delegate_ = brave::TabViewGuest::FromWebContents(web_contents);
@@ -473,6 +498,9 @@ WebContents::WebContents(v8::Isolate* isolate,
     enable_devtools_(true),
     is_being_destroyed_(false),
     guest_delegate_(nullptr),
+    coalesce_events_(false),
+    coalescing_interval_(base::TimeDelta::FromMilliseconds(
+        kDefaultCoalescingIntervalMs)),
     weak_ptr_factory_(this) {
   CreateWebContents(isolate, options, create_params);
 }
@@ -483,6 +511,9 @@ WebContents::WebContents(v8::Isolate* isolate, const mate::Dictionary& options)
       enable_devtools_(true),
       is_being_destroyed_(false),
       guest_delegate_(nullptr),
+      coalesce_events_(false),
+      coalescing_interval_(base::TimeDelta::FromMilliseconds(
+          kDefaultCoalescingIntervalMs)),
       weak_ptr_factory_(this) {
   mate::Handle<api::Session> session = SessionFromOptions(isolate, options);
 
@@ -998,17 +1029,21 @@ void WebContents::ActivateContents(content::WebContents* source) {
 
 void WebContents::UpdateTargetURL(content::WebContents* source,
                                   const GURL& url) {
+  // Querying the cursor is only worth it when someone listens.
+  if (!HasListeners("update-target-url"))
+    return;
+
   const gfx::Point& location =
       display::Screen::GetScreen()->GetCursorScreenPoint();
   const gfx::Rect& bounds = web_contents()->GetContainerBounds();
   int x = location.x() - bounds.x();
   int y = location.y() - bounds.y();
-  Emit("update-target-url", url, x, y);
+  EmitCoalesced("update-target-url", "update-target-url", url, x, y);
 }
 
 void WebContents::LoadProgressChanged(content::WebContents* source,
                                    double progress) {
-  Emit("load-progress-changed", progress);
+  EmitCoalesced("load-progress-changed", "load-progress-changed", progress);
 }
 
 bool WebContents::IsPopupOrPanel(const content::WebContents* source) const {
@@ -1329,14 +1364,14 @@ void WebContents::PluginCrashed(const base::FilePath& plugin_path,
 
 void WebContents::MediaStartedPlaying(const MediaPlayerInfo& media_info,
                                       const MediaPlayerId& id) {
-  Emit("media-started-playing");
+  EmitCoalesced("media-started-playing", "media-started-playing");
 }
 
 void WebContents::MediaStoppedPlaying(const MediaPlayerInfo& media_info,
                                       const MediaPlayerId& id,
                                       WebContentsObserver::MediaStoppedReason
                                       reason) {
-  Emit("media-paused");
+  EmitCoalesced("media-paused", "media-paused");
 }
 
 void WebContents::DidChangeThemeColor(SkColor theme_color) {
@@ -2439,6 +2474,101 @@ void WebContents::CapturePage(mate::Arguments* args) {
       kBGRA_8888_SkColorType);
 }
 
+void WebContents::CaptureThumbnail(mate::Arguments* args) {
+  ThumbnailTabHelper::Options options;
+  if (!args->PeekNext().IsEmpty() && !args->PeekNext()->IsFunction()) {
+    mate::Dictionary dict;
+    if (!args->GetNext(&dict)) {
+      args->ThrowError("`options` must be an object");
+      return;
+    }
+    dict.Get("size", &options.size);
+    dict.Get("quality", &options.quality);
+    dict.Get("force", &options.force);
+    int min_interval;
+    if (dict.Get("minInterval", &min_interval))
+      options.min_interval = base::TimeDelta::FromMilliseconds(min_interval);
+  }
+
+  base::Callback<void(v8::Local<v8::Value>)> callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("`callback` is a required field");
+    return;
+  }
+
+  ThumbnailTabHelper::CreateForWebContents(web_contents());
+  ThumbnailTabHelper::FromWebContents(web_contents())->Capture(
+      options, base::Bind(&OnCaptureThumbnailDone, isolate(), callback));
+}
+
+v8::Local<v8::Value> WebContents::GetThumbnail(v8::Isolate* isolate) {
+  auto* helper = ThumbnailTabHelper::FromWebContents(web_contents());
+  scoped_refptr<base::RefCountedMemory> data =
+      helper ? helper->GetThumbnailData() : nullptr;
+  if (!data)
+    return v8::Null(isolate);
+  return node::Buffer::Copy(isolate, data->front_as<char>(),
+                            data->size()).ToLocalChecked();
+}
+
+void WebContents::SetEventCoalescing(mate::Arguments* args) {
+  bool enable;
+  if (!args->GetNext(&enable)) {
+    args->ThrowError("`enable` must be a boolean");
+    return;
+  }
+
+  int interval;
+  if (args->GetNext(&interval)) {
+    if (interval < 0) {
+      args->ThrowError("`interval` must not be negative");
+      return;
+    }
+    coalescing_interval_ = base::TimeDelta::FromMilliseconds(interval);
+  }
+
+  coalesce_events_ = enable;
+  if (!coalesce_events_) {
+    coalescing_timer_.Stop();
+    FlushCoalescedEvents();
+  }
+}
+
+void WebContents::QueueCoalescedEvent(const std::string& key,
+                                      const base::Closure& emit) {
+  if (!coalescing_timer_.IsRunning()) {
+    coalescing_timer_.Start(FROM_HERE, coalescing_interval_, this,
+                            &WebContents::OnCoalescingTimer);
+    emit.Run();
+    return;
+  }
+
+  for (auto& pending : pending_events_) {
+    if (pending.first == key) {
+      pending.second = emit;
+      return;
+    }
+  }
+  pending_events_.emplace_back(key, emit);
+}
+
+void WebContents::FlushCoalescedEvents() {
+  // Listeners may emit more events.
+  std::vector<std::pair<std::string, base::Closure>> events;
+  events.swap(pending_events_);
+  for (const auto& event : events)
+    event.second.Run();
+}
+
+void WebContents::OnCoalescingTimer() {
+  if (pending_events_.empty())
+    return;
+
+  coalescing_timer_.Start(FROM_HERE, coalescing_interval_, this,
+                          &WebContents::OnCoalescingTimer);
+  FlushCoalescedEvents();
+}
+
 void WebContents::GetPreferredSize(mate::Arguments* args) {
   base::Callback<void(gfx::Size)> callback;
   if (!args->GetNext(&callback)) {
@@ -2662,6 +2792,7 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("isGuest", &WebContents::IsGuest)
       .SetMethod("isRemote", &WebContents::IsRemote)
       .SetMethod("getType", &WebContents::GetType)
+      .SetMethod("_setEventListened", &WebContents::SetEventListened)
       .SetMethod("getWebPreferences", &WebContents::GetWebPreferences)
       .SetMethod("getOwnerBrowserWindow", &WebContents::GetOwnerBrowserWindow)
       .SetMethod("hasServiceWorker", &WebContents::HasServiceWorker)
@@ -2678,6 +2809,9 @@ void WebContents::BuildPrototype(v8::Isolate* isolate,
                  &WebContents::ShowDefinitionForSelection)
       .SetMethod("copyImageAt", &WebContents::CopyImageAt)
       .SetMethod("capturePage", &WebContents::CapturePage)
+      .SetMethod("captureThumbnail", &WebContents::CaptureThumbnail)
+      .SetMethod("getThumbnail", &WebContents::GetThumbnail)
+      .SetMethod("setEventCoalescing", &WebContents::SetEventCoalescing)
       .SetMethod("getPreferredSize", &WebContents::GetPreferredSize)
       .SetProperty("id", &WebContents::ID)
       .SetProperty("attached", &WebContents::IsAttached)
@@ -3002,6 +3136,7 @@ void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
   dict.SetMethod("fromId", &mate::TrackableObject<WebContents>::FromWeakMapID);
   dict.SetMethod("getAllWebContents",
                  &mate::TrackableObject<WebContents>::GetAll);
+  dict.SetMethod("getEventStats", &mate::internal::GetEmitStats);
 }
 
 }  // namespace
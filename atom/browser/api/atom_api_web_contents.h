@@ -7,14 +7,17 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "atom/browser/api/save_page_handler.h"
 #include "atom/browser/api/trackable_object.h"
 #include "atom/browser/common_web_contents_delegate.h"
 #include "atom/common/options_switches.h"
+#include "base/bind.h"
 #include "base/memory/memory_pressure_listener.h"
 #include "base/memory/weak_ptr.h"
+#include "base/timer/timer.h"
 #include "chrome/browser/ui/tabs/tab_strip_model_observer.h"
 #include "content/common/cursors/webcursor.h"
 #include "content/common/view_messages.h"
@@ -273,9 +276,74 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // done.
   void CapturePage(mate::Arguments* args);
 
+  // Captures a small thumbnail of the page, |callback| is called with a
+  // handle describing it. The encoded data is returned by GetThumbnail().
+  void CaptureThumbnail(mate::Arguments* args);
+  v8::Local<v8::Value> GetThumbnail(v8::Isolate* isolate);
+
   void EnablePreferredSizeMode(bool enable);
   void GetPreferredSize(mate::Arguments* args);
 
+  // Turns coalescing of the progress-style events on or off, see
+  // EmitCoalesced().
+  void SetEventCoalescing(mate::Arguments* args);
+
+  // The emit methods below emit the coalesced events that are pending
+  // before |name|, so listeners still see the events in the order they
+  // happened. They hide the ones of mate::EventEmitter instead of overriding
+  // them, so events emitted through a mate::TrackableObject<WebContents> or
+  // mate::EventEmitter pointer skip the flush and may overtake the pending
+  // events. Always emit through WebContents.
+  template<typename... Args>
+  bool Emit(const base::StringPiece& name, const Args&... args) {
+    FlushPendingEvents();
+    return mate::TrackableObject<WebContents>::Emit(name, args...);
+  }
+
+  template<typename... Args>
+  bool EmitWithSender(const base::StringPiece& name,
+                      content::RenderFrameHost* sender,
+                      IPC::Message* message,
+                      const Args&... args) {
+    FlushPendingEvents();
+    return mate::TrackableObject<WebContents>::EmitWithSender(
+        name, sender, message, args...);
+  }
+
+  template<typename... Args>
+  bool EmitCustomEvent(const base::StringPiece& name,
+                       v8::Local<v8::Object> event,
+                       const Args&... args) {
+    FlushPendingEvents();
+    return mate::TrackableObject<WebContents>::EmitCustomEvent(
+        name, event, args...);
+  }
+
+  template<typename... Args>
+  bool EmitWithFlags(const base::StringPiece& name,
+                     int flags,
+                     const Args&... args) {
+    FlushPendingEvents();
+    return mate::TrackableObject<WebContents>::EmitWithFlags(
+        name, flags, args...);
+  }
+
+  // Emits |name| like Emit() unless coalescing is on. Then events are emitted
+  // at most once per |coalescing_interval_|, and of the events sharing |key|
+  // that arrive in between only the latest is emitted.
+  template<typename... Args>
+  void EmitCoalesced(const std::string& key,
+                     const base::StringPiece& name,
+                     const Args&... args) {
+    if (!coalesce_events_) {
+      Emit(name, args...);
+      return;
+    }
+    QueueCoalescedEvent(
+        key, base::Bind(&WebContents::EmitCoalescedNow<Args...>,
+                        base::Unretained(this), name.as_string(), args...));
+  }
+
   // Methods for creating <webview>.
   void SetSize(const SetSizeParams& params);
   bool IsGuest() const;
@@ -535,6 +603,21 @@ class WebContents : public mate::TrackableObject<WebContents>,
     return ++request_id_;
   }
 
+  template<typename... Args>
+  void EmitCoalescedNow(const std::string& name, const Args&... args) {
+    mate::TrackableObject<WebContents>::Emit(name, args...);
+  }
+
+  // Emits |emit| right away when no event was emitted in the current
+  // interval, otherwise replaces the pending event of |key| with it.
+  void QueueCoalescedEvent(const std::string& key, const base::Closure& emit);
+  void FlushPendingEvents() {
+    if (!pending_events_.empty())
+      FlushCoalescedEvents();
+  }
+  void FlushCoalescedEvents();
+  void OnCoalescingTimer();
+
   // Called when we receive a CursorChange message from chromium.
   void OnCursorChange(const content::WebCursor& cursor);
 
@@ -573,6 +656,16 @@ class WebContents : public mate::TrackableObject<WebContents>,
   // the context menu params for the current context menu;
   content::ContextMenuParams context_menu_params_;
 
+  // Whether progress-style events are coalesced, and how often they can be
+  // emitted when they are.
+  bool coalesce_events_;
+  base::TimeDelta coalescing_interval_;
+  // Coalesced events waiting for |coalescing_timer_|, by key in the order
+  // they first arrived.
+  std::vector<std::pair<std::string, base::Closure>> pending_events_;
+  // Runs for an interval after coalesced events are emitted.
+  base::OneShotTimer coalescing_timer_;
+
   base::WeakPtrFactory<WebContents> weak_ptr_factory_;
 
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
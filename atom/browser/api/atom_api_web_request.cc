@@ -5,16 +5,21 @@
 #include "atom/browser/api/atom_api_web_request.h"
 
 #include "atom/browser/net/atom_network_delegate.h"
+#include "atom/common/api/locker.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/net_converter.h"
+#include "base/callback_helpers.h"
 #include "base/files/file_path.h"
+#include "base/memory/weak_ptr.h"
 #include "chrome/browser/profiles/profile.h"
 #include "content/public/browser/browser_thread.h"
 #include "extensions/features/features.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
+#include "net/base/io_buffer.h"
+#include "net/url_request/url_fetcher_response_writer.h"
 #include "net/url_request/url_request_context.h"
 #include "v8/include/v8.h"
 
@@ -48,12 +53,14 @@ struct Converter<net::URLFetcher::RequestType> {
       *out = net::URLFetcher::RequestType::POST;
     else if (type == "head")
       *out = net::URLFetcher::RequestType::HEAD;
-    else if (type == "delete_request")
+    else if (type == "delete" || type == "delete_request")
       *out = net::URLFetcher::RequestType::DELETE_REQUEST;
     else if (type == "put")
       *out = net::URLFetcher::RequestType::PUT;
     else if (type == "patch")
       *out = net::URLFetcher::RequestType::PATCH;
+    else
+      return false;
     return true;
   }
 };
@@ -64,6 +71,84 @@ namespace atom {
 
 namespace api {
 
+namespace {
+
+using FetchWriter =
+    base::Callback<void(v8::Local<v8::Value>, const base::Closure&)>;
+
+void PostToIOThread(const base::Closure& callback) {
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE, callback);
+}
+
+void RunFetchWriter(v8::Isolate* isolate,
+                    const FetchWriter& writer,
+                    scoped_refptr<net::IOBuffer> buffer,
+                    int num_bytes,
+                    const base::Closure& next) {
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::ArrayBuffer> chunk = v8::ArrayBuffer::New(isolate, num_bytes);
+  memcpy(chunk->GetContents().Data(), buffer->data(), num_bytes);
+  writer.Run(chunk, base::Bind(&PostToIOThread, next));
+}
+
+// Hands each chunk of a fetch response to a JS writer. The next chunk is
+// only read once the writer called |next|, so at most one chunk is held in
+// memory at a time.
+class FetchResponseWriter : public net::URLFetcherResponseWriter {
+ public:
+  FetchResponseWriter(v8::Isolate* isolate, const FetchWriter& writer)
+      : isolate_(isolate),
+        writer_(writer),
+        pending_bytes_(0),
+        weak_factory_(this) {}
+  ~FetchResponseWriter() override {}
+
+  // net::URLFetcherResponseWriter:
+  int Initialize(const net::CompletionCallback& callback) override {
+    return net::OK;
+  }
+
+  int Write(net::IOBuffer* buffer,
+            int num_bytes,
+            const net::CompletionCallback& callback) override {
+    DCHECK_CURRENTLY_ON(BrowserThread::IO);
+    pending_write_ = callback;
+    pending_bytes_ = num_bytes;
+    // |buffer| stays alive until |callback| runs, so it is not copied here.
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(&RunFetchWriter, isolate_, writer_,
+                   make_scoped_refptr(buffer), num_bytes,
+                   base::Bind(&FetchResponseWriter::OnChunkWritten,
+                              weak_factory_.GetWeakPtr())));
+    return net::ERR_IO_PENDING;
+  }
+
+  int Finish(int net_error, const net::CompletionCallback& callback) override {
+    return net::OK;
+  }
+
+ private:
+  void OnChunkWritten() {
+    DCHECK_CURRENTLY_ON(BrowserThread::IO);
+    // |next| may be called more than once.
+    if (pending_write_.is_null())
+      return;
+    base::ResetAndReturn(&pending_write_).Run(pending_bytes_);
+  }
+
+  v8::Isolate* isolate_;
+  FetchWriter writer_;
+  net::CompletionCallback pending_write_;
+  int pending_bytes_;
+
+  base::WeakPtrFactory<FetchResponseWriter> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(FetchResponseWriter);
+};
+
+}  // namespace
+
 WebRequest::WebRequest(v8::Isolate* isolate,
                        Profile* profile)
     : profile_(profile) {
@@ -76,6 +161,7 @@ WebRequest::~WebRequest() {
 
 void WebRequest::OnURLFetchComplete(
     const net::URLFetcher* source) {
+  std::unique_ptr<const net::URLFetcher> fetcher(source);
   FetchCallback callback = fetchers_[source];
   fetchers_.erase(source);
 
@@ -112,13 +198,20 @@ void WebRequest::Fetch(mate::Arguments* args) {
   net::URLFetcher::RequestType request_type = net::URLFetcher::RequestType::GET;
   net::HttpRequestHeaders headers;
   base::FilePath path;
+  FetchWriter writer;
   std::string payload;
   std::string payload_content_type;
   mate::Dictionary dict;
   if (args->GetNext(&dict)) {
-    dict.Get("method", &request_type);
+    v8::Local<v8::Value> method;
+    if (dict.Get("method", &method) && !method->IsUndefined() &&
+        !mate::ConvertFromV8(isolate(), method, &request_type)) {
+      args->ThrowError("invalid method");
+      return;
+    }
     dict.Get("headers", &headers);
     dict.Get("path", &path);
+    dict.Get("writer", &writer);
     if (dict.Get("payload", &payload)) {
       if (!dict.Get("payload_content_type", &payload_content_type)) {
         args->ThrowError("payload_content_type is required for payload");
@@ -139,18 +232,38 @@ void WebRequest::Fetch(mate::Arguments* args) {
     fetcher->SetUploadData(payload_content_type, payload);
   if (!headers.IsEmpty())
     fetcher->SetExtraRequestHeaders(headers.ToString());
-  if (!path.empty())
+  // The body goes straight to |path| or |writer| instead of memory.
+  if (!path.empty()) {
     fetcher->SaveResponseToFileAtPath(
         path,
         BrowserThread::GetTaskRunnerForThread(BrowserThread::FILE));
+  } else if (!writer.is_null()) {
+    fetcher->SaveResponseWithWriter(std::unique_ptr<
+        net::URLFetcherResponseWriter>(
+            new FetchResponseWriter(isolate(), writer)));
+  }
   fetcher->Start();
   fetchers_[fetcher] = FetchCallback(callback);
 }
 
 template<AtomNetworkDelegate::SimpleEvent type>
 void WebRequest::SetSimpleListener(mate::Arguments* args) {
+  // { batch, batchInterval, maxBatchSize } in the filter.
+  AtomNetworkDelegate::BatchOptions batch;
+  mate::Dictionary filter;
+  if (args->Length() > 1 &&
+      mate::ConvertFromV8(isolate(), args->PeekNext(), &filter)) {
+    filter.Get("batch", &batch.enabled);
+    int interval = 0;
+    if (filter.Get("batchInterval", &interval) && interval >= 0)
+      batch.interval = base::TimeDelta::FromMilliseconds(interval);
+    int max_size = 0;
+    if (filter.Get("maxBatchSize", &max_size) && max_size > 0)
+      batch.max_size = max_size;
+  }
+
   SetListener<AtomNetworkDelegate::SimpleListener>(
-      &AtomNetworkDelegate::SetSimpleListenerInIO, type, args);
+      &AtomNetworkDelegate::SetSimpleListenerInIO, type, args, batch);
 }
 
 template<AtomNetworkDelegate::ResponseEvent type>
@@ -159,19 +272,23 @@ void WebRequest::SetResponseListener(mate::Arguments* args) {
       &AtomNetworkDelegate::SetResponseListenerInIO, type, args);
 }
 
-template<typename Listener, typename Method, typename Event>
+template<typename Listener, typename Method, typename Event,
+         typename... Extra>
 void WebRequest::SetListenerOnIOThread(
     const scoped_refptr<net::URLRequestContextGetter>& getter,
-    Method method, Event type, URLPatterns patterns, Listener listener) {
+    Method method, Event type, URLPatterns patterns, Listener listener,
+    Extra... extra) {
   auto delegate = static_cast<AtomNetworkDelegate*>(
       getter->GetURLRequestContext()->network_delegate());
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
                             base::Bind(method, base::Unretained(delegate),
-                            type, patterns, listener));
+                            type, patterns, listener, extra...));
 }
 
-template<typename Listener, typename Method, typename Event>
-void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
+template<typename Listener, typename Method, typename Event,
+         typename... Extra>
+void WebRequest::SetListener(Method method, Event type, mate::Arguments* args,
+                             Extra... extra) {
   // { urls }.
   URLPatterns patterns;
   mate::Dictionary dict;
@@ -187,11 +304,45 @@ void WebRequest::SetListener(Method method, Event type, mate::Arguments* args) {
   }
 
   BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
-      base::Bind(&WebRequest::SetListenerOnIOThread<Listener, Method, Event>,
+      base::Bind(
+        &WebRequest::SetListenerOnIOThread<Listener, Method, Event, Extra...>,
         base::Unretained(this),
         scoped_refptr<net::URLRequestContextGetter>(
           profile_->GetRequestContext()),
-          method, type, patterns, listener));
+          method, type, patterns, listener, extra...));
+}
+
+// static
+void WebRequest::SetRulesOnIOThread(
+    const scoped_refptr<net::URLRequestContextGetter>& getter,
+    const WebRequestRules& rules) {
+  auto delegate = static_cast<AtomNetworkDelegate*>(
+      getter->GetURLRequestContext()->network_delegate());
+  delegate->SetRulesInIO(rules);
+}
+
+void WebRequest::SetDeclarativeRules(mate::Arguments* args) {
+  // Array of rules, or null to remove all of them.
+  base::ListValue list;
+  v8::Local<v8::Value> value;
+  if (!args->GetNext(&list) &&
+      !(args->GetNext(&value) && value->IsNull())) {
+    args->ThrowError("Must pass null or an Array of rules");
+    return;
+  }
+
+  WebRequestRules rules;
+  std::string error;
+  if (!ParseWebRequestRules(list, &rules, &error)) {
+    args->ThrowError(error);
+    return;
+  }
+
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+      base::Bind(&WebRequest::SetRulesOnIOThread,
+        scoped_refptr<net::URLRequestContextGetter>(
+          profile_->GetRequestContext()),
+        rules));
 }
 
 void WebRequest::HandleBehaviorChanged() {
@@ -238,6 +389,8 @@ void WebRequest::BuildPrototype(v8::Isolate* isolate,
       .SetMethod("onErrorOccurred",
                  &WebRequest::SetSimpleListener<
                     AtomNetworkDelegate::kOnErrorOccurred>)
+      .SetMethod("setDeclarativeRules",
+                 &WebRequest::SetDeclarativeRules)
       .SetMethod("handleBehaviorChanged",
                  &WebRequest::HandleBehaviorChanged)
       .SetMethod("fetch",
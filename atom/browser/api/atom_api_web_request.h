@@ -51,6 +51,7 @@ class WebRequest : public mate::TrackableObject<WebRequest>,
       const mate::Dictionary&,
       v8::Local<v8::String>)> FetchCallback;
   void HandleBehaviorChanged();
+  void SetDeclarativeRules(mate::Arguments* args);
   void Fetch(mate::Arguments* args);
   void OnURLFetchComplete(const net::URLFetcher* source) override;
 
@@ -59,13 +60,19 @@ class WebRequest : public mate::TrackableObject<WebRequest>,
   void SetSimpleListener(mate::Arguments* args);
   template<AtomNetworkDelegate::ResponseEvent type>
   void SetResponseListener(mate::Arguments* args);
-  template<typename Listener, typename Method, typename Event>
+  static void SetRulesOnIOThread(
+      const scoped_refptr<net::URLRequestContextGetter>& request_context,
+      const WebRequestRules& rules);
+  template<typename Listener, typename Method, typename Event,
+           typename... Extra>
   void SetListenerOnIOThread(
       const scoped_refptr<net::URLRequestContextGetter>& request_context,
       Method method, Event type,
-      URLPatterns patterns, Listener listener);
-  template<typename Listener, typename Method, typename Event>
-  void SetListener(Method method, Event type, mate::Arguments* args);
+      URLPatterns patterns, Listener listener, Extra... extra);
+  template<typename Listener, typename Method, typename Event,
+           typename... Extra>
+  void SetListener(Method method, Event type, mate::Arguments* args,
+                   Extra... extra);
 
  private:
   Profile* profile_;
@@ -4,10 +4,13 @@
 
 #include "atom/browser/api/event_emitter.h"
 
+#include <map>
+
 #include "atom/browser/api/atom_api_web_contents.h"
 #include "atom/browser/api/event.h"
 #include "atom/common/native_mate_converters/string16_converter.h"
 #include "atom/common/native_mate_converters/value_converter.h"
+#include "base/macros.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/render_process_host.h"
@@ -26,6 +29,24 @@ namespace {
 
 v8::Persistent<v8::ObjectTemplate> event_template;
 
+struct EmitStats {
+  EmitStats() : emitted(0), skipped(0) {}
+
+  // Events dispatched to JS, and the time spent dispatching them.
+  int64_t emitted;
+  base::TimeDelta js_time;
+  // Events dropped because they had no listeners.
+  int64_t skipped;
+};
+
+using EmitStatsMap = std::map<std::string, EmitStats>;
+
+// Only used on the UI thread.
+EmitStatsMap& GetEmitStatsMap() {
+  CR_DEFINE_STATIC_LOCAL(EmitStatsMap, emit_stats, ());
+  return emit_stats;
+}
+
 void PreventDefault(mate::Arguments* args) {
   mate::Dictionary self(args->isolate(), args->GetThis());
   self.Set("defaultPrevented", true);
@@ -107,6 +128,28 @@ v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags) {
   return obj.GetHandle();
 }
 
+void RecordEmit(const base::StringPiece& name, base::TimeDelta js_time) {
+  EmitStats& stats = GetEmitStatsMap()[name.as_string()];
+  ++stats.emitted;
+  stats.js_time += js_time;
+}
+
+void RecordSkippedEmit(const base::StringPiece& name) {
+  ++GetEmitStatsMap()[name.as_string()].skipped;
+}
+
+v8::Local<v8::Value> GetEmitStats(v8::Isolate* isolate) {
+  mate::Dictionary result = mate::Dictionary::CreateEmpty(isolate);
+  for (const auto& it : GetEmitStatsMap()) {
+    mate::Dictionary stats = mate::Dictionary::CreateEmpty(isolate);
+    stats.Set("emitted", static_cast<double>(it.second.emitted));
+    stats.Set("skipped", static_cast<double>(it.second.skipped));
+    stats.Set("jsTime", it.second.js_time.InMillisecondsF());
+    result.Set(it.first, stats);
+  }
+  return result.GetHandle();
+}
+
 }  // namespace internal
 
 }  // namespace mate
@@ -5,9 +5,13 @@
 #ifndef ATOM_BROWSER_API_EVENT_EMITTER_H_
 #define ATOM_BROWSER_API_EVENT_EMITTER_H_
 
+#include <set>
+#include <string>
 #include <vector>
 
 #include "atom/common/api/event_emitter_caller.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
 #include "native_mate/wrappable.h"
 
 namespace content {
@@ -32,6 +36,11 @@ v8::Local<v8::Object> CreateCustomEvent(
     v8::Local<v8::Object> event);
 v8::Local<v8::Object> CreateEventFromFlags(v8::Isolate* isolate, int flags);
 
+// Diagnostics of the emitters that track their listeners, keyed by event name.
+void RecordEmit(const base::StringPiece& name, base::TimeDelta js_time);
+void RecordSkippedEmit(const base::StringPiece& name);
+v8::Local<v8::Value> GetEmitStats(v8::Isolate* isolate);
+
 }  // namespace internal
 
 // Provide helperers to emit event in JavaScript.
@@ -45,11 +54,31 @@ class EventEmitter : public Wrappable<T> {
   v8::Local<v8::Object> GetWrapper() { return Wrappable<T>::GetWrapper(); }
   v8::Isolate* isolate() const { return Wrappable<T>::isolate(); }
 
+  // Whether |name| may have JS listeners. Emitting an event that has none
+  // returns before doing any V8 work.
+  bool HasListeners(const base::StringPiece& name) const {
+    return !track_listeners_ || listened_events_.count(name.as_string()) > 0;
+  }
+
+  // Called by JS whenever the listeners of |name| change, from then on only
+  // the events that have listeners are emitted.
+  void SetEventListened(const std::string& name, bool listened) {
+    track_listeners_ = true;
+    if (listened)
+      listened_events_.insert(name);
+    else
+      listened_events_.erase(name);
+  }
+
   // this.emit(name, event, args...);
   template<typename... Args>
   bool EmitCustomEvent(const base::StringPiece& name,
                        v8::Local<v8::Object> event,
                        const Args&... args) {
+    if (!HasListeners(name)) {
+      internal::RecordSkippedEmit(name);
+      return false;
+    }
     return EmitWithEvent(
         name,
         internal::CreateCustomEvent(isolate(), GetWrapper(), event), args...);
@@ -60,6 +89,10 @@ class EventEmitter : public Wrappable<T> {
   bool EmitWithFlags(const base::StringPiece& name,
                      int flags,
                      const Args&... args) {
+    if (!HasListeners(name)) {
+      internal::RecordSkippedEmit(name);
+      return false;
+    }
     return EmitCustomEvent(
         name,
         internal::CreateEventFromFlags(isolate(), flags), args...);
@@ -77,6 +110,10 @@ class EventEmitter : public Wrappable<T> {
                       content::RenderFrameHost* sender,
                       IPC::Message* message,
                       const Args&... args) {
+    if (!HasListeners(name)) {
+      internal::RecordSkippedEmit(name);
+      return false;
+    }
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
     v8::Local<v8::Object> wrapper = GetWrapper();
@@ -88,7 +125,7 @@ class EventEmitter : public Wrappable<T> {
   }
 
  protected:
-  EventEmitter() {}
+  EventEmitter() : track_listeners_(false) {}
 
  private:
   // this.emit(name, event, args...);
@@ -98,11 +135,22 @@ class EventEmitter : public Wrappable<T> {
                      const Args&... args) {
     v8::Locker locker(isolate());
     v8::HandleScope handle_scope(isolate());
-    EmitEvent(isolate(), GetWrapper(), name, event, args...);
+    if (!track_listeners_) {
+      EmitEvent(isolate(), GetWrapper(), name, event, args...);
+    } else {
+      base::TimeTicks start = base::TimeTicks::Now();
+      EmitEvent(isolate(), GetWrapper(), name, event, args...);
+      internal::RecordEmit(name, base::TimeTicks::Now() - start);
+    }
     return event->Get(
         StringToV8(isolate(), "defaultPrevented"))->BooleanValue();
   }
 
+  // Whether JS reports the listeners of this emitter.
+  bool track_listeners_;
+  // Events that have JS listeners, only used when |track_listeners_| is set.
+  std::set<std::string> listened_events_;
+
   DISALLOW_COPY_AND_ASSIGN(EventEmitter);
 };
 
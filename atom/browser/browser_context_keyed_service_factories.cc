@@ -18,6 +18,7 @@
 #include "chrome/browser/plugins/plugin_prefs_factory.h"
 #endif
 #if BUILDFLAG(ENABLE_EXTENSIONS)
+#include "atom/browser/extensions/atom_browser_client_extensions_part.h"
 #include "atom/browser/extensions/atom_extension_system_factory.h"
 #include "extensions/browser/api/alarms/alarm_manager.h"
 #include "extensions/browser/api/api_resource_manager.h"
@@ -74,6 +75,8 @@ void EnsureBrowserContextKeyedServiceFactoriesBuilt() {
   extensions::StorageFrontend::GetFactoryInstance();
   extensions::WebRequestAPI::GetFactoryInstance();
   extensions::AtomExtensionSystemFactory::GetInstance();
+  extensions::AtomBrowserClientExtensionsPart::
+      EnsureShutdownNotifierFactoryBuilt();
 #if BUILDFLAG(ENABLE_SPELLCHECK)
   extensions::SpellcheckAPI::GetFactoryInstance();
 #endif
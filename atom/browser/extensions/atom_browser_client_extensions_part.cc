@@ -4,11 +4,21 @@
 
 #include "atom/browser/extensions/atom_browser_client_extensions_part.h"
 
+#include <string.h>
+
 #include <map>
+#include <memory>
 #include <set>
+#include <string>
+#include <utility>
 
 #include "atom/common/api/api_messages.h"
+#include "atom/common/content_settings_snapshot.h"
 #include "base/command_line.h"
+#include "base/memory/shared_memory.h"
+#include "base/memory/singleton.h"
+#include "base/metrics/histogram_macros.h"
+#include "base/values.h"
 #include "brave/browser/api/brave_api_extension.h"
 #include "chrome/browser/browser_process.h"
 #include "chrome/browser/profiles/profile.h"
@@ -16,8 +26,10 @@
 #include "chrome/browser/renderer_host/chrome_extension_message_filter.h"
 #include "chrome/common/chrome_constants.h"
 #include "chrome/common/pref_names.h"
+#include "components/content_settings/core/common/content_settings.h"
 #include "components/prefs/pref_change_registrar.h"
 #include "components/prefs/pref_registry_simple.h"
+#include "components/keyed_service/content/browser_context_keyed_service_shutdown_notifier_factory.h"
 #include "components/prefs/pref_service.h"
 #include "components/user_prefs/user_prefs.h"
 #include "content/public/browser/browser_thread.h"
@@ -91,6 +103,276 @@ RenderProcessHostPrivilege GetProcessPrivilege(
 
 static std::map<int, void*> render_process_hosts_;
 
+// Notifies the content settings snapshots of the browser contexts that are
+// shutting down, off the record contexts included.
+class ContentSettingsShutdownNotifierFactory
+    : public BrowserContextKeyedServiceShutdownNotifierFactory {
+ public:
+  static ContentSettingsShutdownNotifierFactory* GetInstance() {
+    return base::Singleton<ContentSettingsShutdownNotifierFactory>::get();
+  }
+
+ private:
+  friend struct base::DefaultSingletonTraits<
+      ContentSettingsShutdownNotifierFactory>;
+
+  ContentSettingsShutdownNotifierFactory()
+      : BrowserContextKeyedServiceShutdownNotifierFactory(
+            "ContentSettingsSnapshot") {}
+  ~ContentSettingsShutdownNotifierFactory() override {}
+
+  content::BrowserContext* GetBrowserContextToUse(
+      content::BrowserContext* context) const override {
+    return context;
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsShutdownNotifierFactory);
+};
+
+// Renderers compile the rules of deltas on top of their snapshot, once they
+// would hold more than this many they get a new snapshot instead.
+const size_t kMaxContentSettingsDeltaRules = 100;
+
+const char kFirstPartyPattern[] = "[firstParty]";
+
+// The content settings snapshot shared with the renderers of a browser
+// context.
+struct ContentSettingsState {
+  ContentSettingsState() : version(0), size(0), delta_rule_count(0) {}
+
+  // Bumped on every change of the content settings.
+  uint64_t version;
+  // Kept mapped, it is the base the next delta is computed from.
+  std::unique_ptr<base::SharedMemory> snapshot;
+  size_t size;
+  // The change from |version| - 1 to |version|, null when there is none.
+  std::unique_ptr<base::ListValue> delta;
+  size_t delta_rule_count;
+  // Drops the state when its browser context shuts down.
+  std::unique_ptr<KeyedServiceShutdownNotifier::Subscription>
+      shutdown_subscription;
+};
+
+// What a render process has been sent.
+struct ContentSettingsHost {
+  ContentSettingsHost() : context(nullptr), version(0), delta_rule_count(0) {}
+
+  content::BrowserContext* context;
+  uint64_t version;
+  // Rules sent as deltas since the last snapshot.
+  size_t delta_rule_count;
+};
+
+static std::map<content::BrowserContext*, ContentSettingsState>
+    content_settings_states_;
+static std::map<int, ContentSettingsHost> content_settings_hosts_;
+
+void OnBrowserContextShutdown(content::BrowserContext* context) {
+  content_settings_states_.erase(context);
+
+  for (auto it = content_settings_hosts_.begin();
+       it != content_settings_hosts_.end();) {
+    if (it->second.context == context)
+      it = content_settings_hosts_.erase(it);
+    else
+      ++it;
+  }
+}
+
+// Returns the state of |context|, creating it if needed.
+ContentSettingsState& GetContentSettingsState(
+    content::BrowserContext* context) {
+  ContentSettingsState& state = content_settings_states_[context];
+  if (!state.shutdown_subscription) {
+    state.shutdown_subscription =
+        ContentSettingsShutdownNotifierFactory::GetInstance()
+            ->Get(context)
+            ->Subscribe(base::Bind(&OnBrowserContextShutdown, context));
+  }
+  return state;
+}
+
+bool RulesEqual(const atom::ContentSettingsSnapshot& a,
+                int a_type,
+                uint32_t a_index,
+                const atom::ContentSettingsSnapshot& b,
+                int b_type,
+                uint32_t b_index) {
+  const atom::ContentSettingsSnapshot::Rule& a_rule =
+      a.GetRule(a_type, a_index);
+  const atom::ContentSettingsSnapshot::Rule& b_rule =
+      b.GetRule(b_type, b_index);
+  return a_rule.setting == b_rule.setting &&
+         a_rule.first_party == b_rule.first_party &&
+         a.GetString(a_rule.primary_pattern_offset,
+                     a_rule.primary_pattern_length) ==
+             b.GetString(b_rule.primary_pattern_offset,
+                         b_rule.primary_pattern_length) &&
+         a.GetString(a_rule.secondary_pattern_offset,
+                     a_rule.secondary_pattern_length) ==
+             b.GetString(b_rule.secondary_pattern_offset,
+                         b_rule.secondary_pattern_length);
+}
+
+// Appends the rules of |content_type| from |first| on to |rules|, in the
+// format of the content_settings pref.
+void AppendContentSettingsRules(const atom::ContentSettingsSnapshot& snapshot,
+                                int content_type,
+                                uint32_t first,
+                                base::ListValue* rules) {
+  for (uint32_t i = first; i < snapshot.GetRuleCount(content_type); ++i) {
+    const atom::ContentSettingsSnapshot::Rule& rule =
+        snapshot.GetRule(content_type, i);
+    std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+    dict->SetString("primaryPattern",
+        snapshot.GetString(rule.primary_pattern_offset,
+                           rule.primary_pattern_length));
+    if (rule.first_party) {
+      dict->SetString("secondaryPattern", kFirstPartyPattern);
+    } else {
+      dict->SetString("secondaryPattern",
+          snapshot.GetString(rule.secondary_pattern_offset,
+                             rule.secondary_pattern_length));
+    }
+    dict->SetString("setting",
+        rule.setting == CONTENT_SETTING_BLOCK ? "block" : "allow");
+    rules->Append(std::move(dict));
+  }
+}
+
+void AddContentSettingsOp(base::ListValue* ops,
+                          const std::string& op,
+                          const std::string& content_type,
+                          std::unique_ptr<base::ListValue> rules) {
+  std::unique_ptr<base::DictionaryValue> dict(new base::DictionaryValue);
+  dict->SetString("op", op);
+  dict->SetString("contentType", content_type);
+  if (rules)
+    dict->Set("rules", std::move(rules));
+  ops->Append(std::move(dict));
+}
+
+// Rules appended to a content type are sent as "add", any other change to a
+// content type replaces all of its rules. |rule_count| is set to the number
+// of rules in the ops.
+std::unique_ptr<base::ListValue> ComputeContentSettingsDelta(
+    const atom::ContentSettingsSnapshot& old_snapshot,
+    const atom::ContentSettingsSnapshot& new_snapshot,
+    size_t* rule_count) {
+  std::unique_ptr<base::ListValue> ops(new base::ListValue);
+  *rule_count = 0;
+  for (const std::string& name : new_snapshot.GetContentTypes()) {
+    int new_type = new_snapshot.FindContentType(name);
+    uint32_t new_count = new_snapshot.GetRuleCount(new_type);
+    int old_type = old_snapshot.FindContentType(name);
+    uint32_t old_count =
+        old_type < 0 ? 0 : old_snapshot.GetRuleCount(old_type);
+
+    uint32_t common = 0;
+    while (old_type >= 0 && common < old_count && common < new_count &&
+           RulesEqual(old_snapshot, old_type, common,
+                      new_snapshot, new_type, common))
+      ++common;
+
+    if (old_type >= 0 && common == old_count && common == new_count)
+      continue;
+
+    std::unique_ptr<base::ListValue> rules(new base::ListValue);
+    if (old_type >= 0 && common == old_count) {
+      AppendContentSettingsRules(new_snapshot, new_type, common, rules.get());
+      *rule_count += rules->GetSize();
+      AddContentSettingsOp(ops.get(), "add", name, std::move(rules));
+    } else {
+      AppendContentSettingsRules(new_snapshot, new_type, 0, rules.get());
+      *rule_count += rules->GetSize();
+      AddContentSettingsOp(ops.get(), "replace", name, std::move(rules));
+    }
+  }
+
+  for (const std::string& name : old_snapshot.GetContentTypes()) {
+    if (new_snapshot.FindContentType(name) < 0)
+      AddContentSettingsOp(ops.get(), "remove", name, nullptr);
+  }
+  return ops;
+}
+
+// Rebuilds the snapshot of |context| from its prefs and computes the delta
+// from the previous one. Returns false if the content settings didn't change
+// or the snapshot couldn't be created.
+bool UpdateContentSettingsSnapshot(content::BrowserContext* context) {
+  const base::DictionaryValue* content_settings =
+      user_prefs::UserPrefs::Get(context)->GetDictionary("content_settings");
+  ContentSettingsState& state = GetContentSettingsState(context);
+
+  std::string blob =
+      atom::ContentSettingsSnapshot::Serialize(*content_settings);
+  std::unique_ptr<base::ListValue> delta;
+  size_t delta_rule_count = 0;
+  if (state.snapshot) {
+    atom::ContentSettingsSnapshot old_snapshot(state.snapshot->memory(),
+                                               state.size);
+    atom::ContentSettingsSnapshot new_snapshot(blob.data(), blob.size());
+    delta = ComputeContentSettingsDelta(old_snapshot, new_snapshot,
+                                        &delta_rule_count);
+    if (delta->empty())
+      return false;
+  }
+
+  std::unique_ptr<base::SharedMemory> snapshot(new base::SharedMemory);
+  base::SharedMemoryCreateOptions options;
+  options.size = blob.size();
+  options.share_read_only = true;
+  if (!snapshot->Create(options) || !snapshot->Map(blob.size())) {
+    LOG(ERROR) << "Could not create content settings snapshot";
+    return false;
+  }
+  memcpy(snapshot->memory(), blob.data(), blob.size());
+
+  state.version++;
+  state.snapshot = std::move(snapshot);
+  state.size = blob.size();
+  state.delta = std::move(delta);
+  state.delta_rule_count = delta_rule_count;
+  UMA_HISTOGRAM_COUNTS("Brave.ContentSettings.SnapshotBytes", blob.size());
+  return true;
+}
+
+// Sends |host| the delta to the current version when it has the version
+// before and the rules still fit in its overlay, and a handle to the current
+// snapshot otherwise. Returns the number of settings bytes sent, the size of
+// the delta message or of the snapshot.
+size_t SendContentSettings(content::RenderProcessHost* host,
+                           ContentSettingsHost* host_state) {
+  const ContentSettingsState& state =
+      GetContentSettingsState(host_state->context);
+  if (!state.snapshot || host_state->version == state.version)
+    return 0;
+
+  IPC::Message* message = nullptr;
+  size_t size = 0;
+  if (state.delta && host_state->version + 1 == state.version &&
+      host_state->delta_rule_count + state.delta_rule_count <=
+          kMaxContentSettingsDeltaRules) {
+    message = new AtomMsg_UpdateContentSettingsDelta(
+        host_state->version, state.version, *state.delta);
+    size = message->size();
+    host_state->delta_rule_count += state.delta_rule_count;
+  } else {
+    base::SharedMemoryHandle handle = state.snapshot->GetReadOnlyHandle();
+    if (!handle.IsValid())
+      return 0;
+    message = new AtomMsg_UpdateContentSettings(
+        state.version, handle, static_cast<uint32_t>(state.size));
+    // The message only carries the handle, the renderer maps the snapshot.
+    size = state.size;
+    host_state->delta_rule_count = 0;
+  }
+  host_state->version = state.version;
+
+  host->Send(message);
+  return size;
+}
+
 }  // namespace
 
 AtomBrowserClientExtensionsPart::AtomBrowserClientExtensionsPart() {
@@ -99,6 +381,11 @@ AtomBrowserClientExtensionsPart::AtomBrowserClientExtensionsPart() {
 AtomBrowserClientExtensionsPart::~AtomBrowserClientExtensionsPart() {
 }
 
+// static
+void AtomBrowserClientExtensionsPart::EnsureShutdownNotifierFactoryBuilt() {
+  ContentSettingsShutdownNotifierFactory::GetInstance();
+}
+
 // static
 bool AtomBrowserClientExtensionsPart::ShouldUseProcessPerSite(
     Profile* profile, const GURL& effective_url) {
@@ -361,7 +648,7 @@ void AtomBrowserClientExtensionsPart::RenderProcessWillLaunch(
     user_prefs_registrar->Add(
         "content_settings",
         base::Bind(&AtomBrowserClientExtensionsPart::UpdateContentSettings,
-                   base::Unretained(this)));
+                   base::Unretained(this), host->GetBrowserContext()));
   }
   UpdateContentSettingsForHost(host->GetID());
 }
@@ -424,21 +711,47 @@ void AtomBrowserClientExtensionsPart::UpdateContentSettingsForHost(
   if (!host)
     return;
 
-  auto context =
-      static_cast<atom::AtomBrowserContext*>(host->GetBrowserContext());
-  auto user_prefs = user_prefs::UserPrefs::Get(context);
-  const base::DictionaryValue* content_settings =
-    user_prefs->GetDictionary("content_settings");
-  host->Send(new AtomMsg_UpdateContentSettings(*content_settings));
+  // A newly launched renderer always gets the current snapshot, which is
+  // kept up to date by UpdateContentSettings.
+  content::BrowserContext* context = host->GetBrowserContext();
+  ContentSettingsHost& host_state =
+      content_settings_hosts_[render_process_id];
+  host_state = ContentSettingsHost();
+  host_state.context = context;
+  if (!GetContentSettingsState(context).snapshot)
+    UpdateContentSettingsSnapshot(context);
+  size_t size = SendContentSettings(host, &host_state);
+  if (size > 0)
+    UMA_HISTOGRAM_COUNTS("Brave.ContentSettings.FullSyncBytes", size);
 }
 
-void AtomBrowserClientExtensionsPart::UpdateContentSettings() {
-  for (std::map<int, void*>::iterator
-      it = render_process_hosts_.begin();
-      it != render_process_hosts_.end();
-      ++it) {
-    UpdateContentSettingsForHost(it->first);
+void AtomBrowserClientExtensionsPart::UpdateContentSettings(
+    content::BrowserContext* context) {
+  // The snapshot and the delta are built once and sent to every renderer of
+  // |context|.
+  if (!UpdateContentSettingsSnapshot(context))
+    return;
+
+  size_t bytes_sent = 0;
+  for (auto it = content_settings_hosts_.begin();
+       it != content_settings_hosts_.end();) {
+    if (it->second.context != context) {
+      ++it;
+      continue;
+    }
+
+    auto host = content::RenderProcessHost::FromID(it->first);
+    if (!host) {
+      it = content_settings_hosts_.erase(it);
+      continue;
+    }
+
+    bytes_sent += SendContentSettings(host, &it->second);
+    ++it;
   }
+
+  if (bytes_sent > 0)
+    UMA_HISTOGRAM_COUNTS("Brave.ContentSettings.UpdateBytes", bytes_sent);
 }
 
 void AtomBrowserClientExtensionsPart::SiteInstanceGotProcess(
@@ -40,6 +40,10 @@ class AtomBrowserClientExtensionsPart {
   AtomBrowserClientExtensionsPart();
   ~AtomBrowserClientExtensionsPart();
 
+  // Registers the factory that notifies the content settings snapshots of
+  // browser context shutdowns, must be called before any context is created.
+  static void EnsureShutdownNotifierFactoryBuilt();
+
   // Corresponds to the AtomBrowserClient function of the same name.
   static GURL GetEffectiveURL(Profile* profile,
                               const GURL& url);
@@ -92,7 +96,7 @@ class AtomBrowserClientExtensionsPart {
   std::string GetApplicationLocale();
 
  private:
-  void UpdateContentSettings();
+  void UpdateContentSettings(content::BrowserContext* context);
   void UpdateContentSettingsForHost(int render_process_id);
 
 
@@ -17,9 +17,12 @@
 #include "base/message_loop/message_loop.h"
 #include "base/path_service.h"
 #include "base/threading/thread_task_runner_handle.h"
+#include "chrome/common/chrome_paths.h"
 #include "brave/common/extensions/crash_reporter_bindings.h"
 #include "brave/common/extensions/crypto_bindings.h"
 #include "brave/common/extensions/file_bindings.h"
+#include "brave/common/extensions/module_code_cache.h"
+#include "brave/common/extensions/module_compiler_bindings.h"
 #include "brave/common/extensions/path_bindings.h"
 #include "brave/common/extensions/shared_memory_bindings.h"
 #include "brave/common/extensions/url_bindings.h"
@@ -128,6 +131,35 @@ JavascriptEnvironment::JavascriptEnvironment()
       handle_scope_(isolate_),
       context_holder_(new gin::ContextHolder(isolate_)),
       source_map_(GetModuleSearchPaths()) {
+  CreateContext();
+}
+
+JavascriptEnvironment::~JavascriptEnvironment() {
+  context()->Exit();
+  if (script_context_.get() && script_context_->is_valid()) {
+    script_context_->Invalidate();
+  }
+}
+
+void JavascriptEnvironment::ResetContext() {
+  script_context_->Invalidate();
+  context()->Exit();
+  script_context_.reset();
+  context_holder_.reset(new gin::ContextHolder(isolate_));
+  isolate_->ContextDisposedNotification();
+  CreateContext();
+}
+
+void JavascriptEnvironment::OnMessageLoopCreated() {
+  isolate_holder_->AddRunMicrotasksObserver();
+}
+
+void JavascriptEnvironment::OnMessageLoopDestroying() {
+  isolate_holder_->RemoveRunMicrotasksObserver();
+}
+
+void JavascriptEnvironment::CreateContext() {
+  v8::HandleScope handle_scope(isolate_);
   v8::Local<v8::ObjectTemplate> templ = ObjectTemplateBuilder(isolate_).Build();
 
   v8::Local<v8::Context> ctx =
@@ -150,6 +182,10 @@ JavascriptEnvironment::JavascriptEnvironment()
     script_context_->module_system()->RegisterNativeHandler(
       "path", std::unique_ptr<extensions::NativeHandler>(
           new brave::PathBindings(script_context_.get(), &source_map_)));
+    script_context_->module_system()->RegisterNativeHandler(
+      "module_compiler", std::unique_ptr<extensions::NativeHandler>(
+          new brave::ModuleCompilerBindings(script_context_.get(),
+                                            &source_map_)));
   }
 
   v8::Local<v8::Object> global = context()->Global();
@@ -178,21 +214,6 @@ JavascriptEnvironment::JavascriptEnvironment()
   muon->Set(v8::String::NewFromUtf8(isolate_, "crypto"), crypto);
 }
 
-JavascriptEnvironment::~JavascriptEnvironment() {
-  context()->Exit();
-  if (script_context_.get() && script_context_->is_valid()) {
-    script_context_->Invalidate();
-  }
-}
-
-void JavascriptEnvironment::OnMessageLoopCreated() {
-  isolate_holder_->AddRunMicrotasksObserver();
-}
-
-void JavascriptEnvironment::OnMessageLoopDestroying() {
-  isolate_holder_->RemoveRunMicrotasksObserver();
-}
-
 bool JavascriptEnvironment::Initialize() {
   auto cmd = base::CommandLine::ForCurrentProcess();
 
@@ -206,6 +227,12 @@ bool JavascriptEnvironment::Initialize() {
     gin::V8Initializer::LoadV8Natives();
   #endif
 
+  base::FilePath user_data_dir;
+  if (base::PathService::Get(chrome::DIR_USER_DATA, &user_data_dir)) {
+    brave::ModuleCodeCache::GetInstance()->SetCacheDirectory(
+        user_data_dir.Append(FILE_PATH_LITERAL("ModuleCodeCache")));
+  }
+
   gin::IsolateHolder::Initialize(gin::IsolateHolder::kNonStrictMode,
                                  gin::IsolateHolder::kStableV8Extras,
                                  gin::ArrayBufferAllocator::SharedInstance());
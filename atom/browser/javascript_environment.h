@@ -28,6 +28,10 @@ class JavascriptEnvironment {
   void OnMessageLoopCreated();
   void OnMessageLoopDestroying();
 
+  // Replaces the context and its module system with fresh ones, keeping the
+  // isolate.
+  void ResetContext();
+
   v8::Isolate* isolate() const { return isolate_; }
   extensions::ScriptContext* script_context() const {
     return script_context_.get();
@@ -43,6 +47,7 @@ class JavascriptEnvironment {
 
  private:
   bool Initialize();
+  void CreateContext();
 
   bool initialized_;
   std::unique_ptr<gin::IsolateHolder> isolate_holder_;
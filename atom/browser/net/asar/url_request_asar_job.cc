@@ -16,6 +16,7 @@
 #include "base/strings/string_util.h"
 #include "base/synchronization/lock.h"
 #include "base/task_runner.h"
+#include "base/task_runner_util.h"
 #include "net/base/file_stream.h"
 #include "net/base/filename_util.h"
 #include "net/base/io_buffer.h"
@@ -66,6 +67,15 @@ void Initialize(
   *type = URLRequestAsarJob::TYPE_ASAR;
 }
 
+// Copies from the mapped archive on the file thread, touching the mapping
+// may have to page the archive in from disk. |archive| keeps it mapped.
+int CopyMappedContents(std::shared_ptr<Archive> archive,
+                       base::StringPiece contents,
+                       scoped_refptr<net::IOBuffer> dest) {
+  memcpy(dest->data(), contents.data(), contents.size());
+  return static_cast<int>(contents.size());
+}
+
 }  // namespace
 
 URLRequestAsarJob::FileMetaInfo::FileMetaInfo()
@@ -109,7 +119,11 @@ void URLRequestAsarJob::Start() {
 }
 
 void URLRequestAsarJob::DidInitialize() {
-  if (type_ == TYPE_ASAR) {
+  if (type_ == TYPE_ASAR &&
+      archive_->GetFileContents(file_path_, &mapped_contents_)) {
+    // Served straight from the mapped archive, no stream is needed.
+    DidOpen(net::OK);
+  } else if (type_ == TYPE_ASAR) {
     InitializeAsarJob();
     int flags = base::File::FLAG_OPEN |
                 base::File::FLAG_READ |
@@ -151,6 +165,19 @@ int URLRequestAsarJob::ReadRawData(net::IOBuffer* dest, int dest_size) {
   if (!dest_size)
     return 0;
 
+  if (!stream_) {
+    size_t position = mapped_contents_.size() - remaining_bytes_;
+    base::PostTaskAndReplyWithResult(
+        file_task_runner_.get(), FROM_HERE,
+        base::Bind(&CopyMappedContents, archive_,
+                   mapped_contents_.substr(position, dest_size),
+                   make_scoped_refptr(dest)),
+        base::Bind(&URLRequestAsarJob::DidRead,
+                   weak_ptr_factory_.GetWeakPtr(),
+                   make_scoped_refptr(dest)));
+    return net::ERR_IO_PENDING;
+  }
+
   int rv = stream_->Read(dest,
                          dest_size,
                          base::Bind(&URLRequestAsarJob::DidRead,
@@ -308,7 +335,11 @@ void URLRequestAsarJob::DidOpen(int result) {
                      byte_range_.first_byte_position() + 1;
   seek_offset_ = byte_range_.first_byte_position() + read_offset;
 
-  if (remaining_bytes_ > 0 && seek_offset_ != 0) {
+  if (!stream_) {
+    mapped_contents_ = mapped_contents_.substr(
+        byte_range_.first_byte_position(), remaining_bytes_);
+    DidSeek(seek_offset_);
+  } else if (remaining_bytes_ > 0 && seek_offset_ != 0) {
     int rv = stream_->Seek(seek_offset_,
                            base::Bind(&URLRequestAsarJob::DidSeek,
                                       weak_ptr_factory_.GetWeakPtr()));
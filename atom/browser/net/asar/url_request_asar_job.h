@@ -13,6 +13,7 @@
 #include "base/files/file_path.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/strings/string_piece.h"
 #include "net/http/http_byte_range.h"
 #include "net/url_request/url_request_job.h"
 
@@ -112,6 +113,10 @@ class URLRequestAsarJob : public net::URLRequestJob {
   std::unique_ptr<net::FileStream> stream_;
   FileMetaInfo meta_info_;
 
+  // The requested range of the file when it is served from the mapped
+  // archive instead of |stream_|. It is only read on |file_task_runner_|.
+  base::StringPiece mapped_contents_;
+
   net::HttpByteRange byte_range_;
   int64_t remaining_bytes_;
   int64_t seek_offset_;
@@ -6,6 +6,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "atom/browser/extensions/tab_helper.h"
 #include "atom/common/native_mate_converters/net_converter.h"
@@ -87,6 +88,24 @@ void RunSimpleListener(const AtomNetworkDelegate::SimpleListener& listener,
   return listener.Run(*(details.get()));
 }
 
+void RunBatchedSimpleListener(
+    const AtomNetworkDelegate::SimpleListener& listener,
+    std::vector<AtomNetworkDelegate::PendingSimpleEvent> events,
+    size_t dropped) {
+  std::unique_ptr<base::ListValue> list(new base::ListValue);
+  for (auto& event : events) {
+    event.details->SetInteger(extensions::tabs_constants::kTabIdKey,
+        GetTabId(event.frame_tree_node_id, event.render_frame_id,
+                 event.render_process_id));
+    list->Append(std::move(event.details));
+  }
+
+  base::DictionaryValue batch;
+  batch.Set("events", std::move(list));
+  batch.SetInteger("dropped", static_cast<int>(dropped));
+  return listener.Run(batch);
+}
+
 void RunResponseListener(
     const AtomNetworkDelegate::ResponseListener& listener,
     std::unique_ptr<base::DictionaryValue> details,
@@ -273,6 +292,12 @@ void ReadFromResponseObject(const base::DictionaryValue& response,
 
 }  // namespace
 
+AtomNetworkDelegate::BatchOptions::BatchOptions()
+    : enabled(false),
+      interval(base::TimeDelta::FromMilliseconds(16)),
+      max_size(500) {
+}
+
 AtomNetworkDelegate::AtomNetworkDelegate() : weak_factory_(this) {
 }
 
@@ -282,11 +307,17 @@ AtomNetworkDelegate::~AtomNetworkDelegate() {
 void AtomNetworkDelegate::SetSimpleListenerInIO(
     SimpleEvent type,
     const URLPatterns& patterns,
-    const SimpleListener& callback) {
+    const SimpleListener& callback,
+    const BatchOptions& batch) {
+  // Queued events belong to the previous listener.
+  pending_events_.erase(type);
+  dropped_events_.erase(type);
+  listener_generations_[type]++;
+
   if (callback.is_null())
     simple_listeners_.erase(type);
   else
-    simple_listeners_[type] = { patterns, callback };
+    simple_listeners_[type] = { patterns, callback, batch };
 }
 
 void AtomNetworkDelegate::SetResponseListenerInIO(
@@ -299,6 +330,10 @@ void AtomNetworkDelegate::SetResponseListenerInIO(
     response_listeners_[type] = { patterns, callback };
 }
 
+void AtomNetworkDelegate::SetRulesInIO(const WebRequestRules& rules) {
+  rules_ = rules;
+}
+
 void AtomNetworkDelegate::SetDevToolsNetworkEmulationClientId(
     const std::string& client_id) {
   base::AutoLock auto_lock(lock_);
@@ -309,6 +344,10 @@ int AtomNetworkDelegate::OnBeforeURLRequest(
     net::URLRequest* request,
     const net::CompletionCallback& callback,
     GURL* new_url) {
+  int result = net::OK;
+  if (ApplyBeforeRequestRules(rules_, request, new_url, &result))
+    return result;
+
   if (!base::ContainsKey(response_listeners_, kOnBeforeRequest))
     return brightray::NetworkDelegate::OnBeforeURLRequest(
         request, callback, new_url);
@@ -330,6 +369,8 @@ int AtomNetworkDelegate::OnBeforeStartTransaction(
     headers->SetHeader(content::ThrottlingNetworkTransaction::
                            kDevToolsEmulateNetworkConditionsClientId,
                        client_id);
+  ApplyRequestHeaderRules(rules_, request, headers);
+
   if (!base::ContainsKey(response_listeners_, kOnBeforeSendHeaders))
     return brightray::NetworkDelegate::OnBeforeStartTransaction(
         request, callback, headers);
@@ -355,14 +396,19 @@ int AtomNetworkDelegate::OnHeadersReceived(
     const net::HttpResponseHeaders* original,
     scoped_refptr<net::HttpResponseHeaders>* override,
     GURL* new_url) {
+  // Listeners see the headers as modified by the rules.
+  const net::HttpResponseHeaders* headers = original;
+  if (ApplyResponseHeaderRules(rules_, request, original, override))
+    headers = override->get();
+
   if (!base::ContainsKey(response_listeners_, kOnHeadersReceived))
     return brightray::NetworkDelegate::OnHeadersReceived(
-        request, callback, original, override, new_url);
+        request, callback, headers, override, new_url);
 
   return HandleResponseEvent(
       kOnHeadersReceived, request, callback,
-      ResponseHeadersContainer(override, original->GetStatusLine(), new_url),
-      original);
+      ResponseHeadersContainer(override, headers->GetStatusLine(), new_url),
+      headers);
 }
 
 void AtomNetworkDelegate::OnBeforeRedirect(net::URLRequest* request,
@@ -484,12 +530,60 @@ void AtomNetworkDelegate::HandleSimpleEvent(
   int render_process_id = -1;
   GetRenderFrameIdAndProcessId(request, &render_frame_id, &render_process_id);
 
+  if (info.batch.enabled) {
+    QueueSimpleEvent(type, { std::move(details), frame_tree_node_id,
+                             render_frame_id, render_process_id });
+    return;
+  }
+
   BrowserThread::PostTask(
       BrowserThread::UI, FROM_HERE,
       base::Bind(RunSimpleListener, info.listener, base::Passed(&details),
           frame_tree_node_id, render_frame_id, render_process_id));
 }
 
+void AtomNetworkDelegate::QueueSimpleEvent(SimpleEvent type,
+                                           PendingSimpleEvent event) {
+  const auto& batch = simple_listeners_[type].batch;
+  auto& pending = pending_events_[type];
+  if (pending.size() >= batch.max_size) {
+    dropped_events_[type]++;
+    return;
+  }
+
+  // The first queued event schedules the flush for the whole batch.
+  if (pending.empty()) {
+    BrowserThread::PostDelayedTask(
+        BrowserThread::IO, FROM_HERE,
+        base::Bind(&AtomNetworkDelegate::FlushSimpleEvents,
+                   weak_factory_.GetWeakPtr(), type,
+                   listener_generations_[type]),
+        batch.interval);
+  }
+  pending.push_back(std::move(event));
+}
+
+void AtomNetworkDelegate::FlushSimpleEvents(SimpleEvent type,
+                                            uint64_t generation) {
+  if (generation != listener_generations_[type])
+    return;
+
+  auto it = pending_events_.find(type);
+  if (it == pending_events_.end() || it->second.empty())
+    return;
+
+  std::vector<PendingSimpleEvent> events;
+  events.swap(it->second);
+  size_t dropped = dropped_events_[type];
+  dropped_events_[type] = 0;
+
+  const auto& info = simple_listeners_[type];
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(RunBatchedSimpleListener, info.listener,
+                 base::Passed(&events), dropped));
+}
+
 template<typename T>
 void AtomNetworkDelegate::OnListenerResultInIO(
     uint64_t id, T out, std::unique_ptr<base::DictionaryValue> response) {
@@ -9,10 +9,13 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "atom/browser/net/web_request_rules.h"
 #include "base/callback.h"
 #include "base/memory/weak_ptr.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "base/values.h"
 #include "brightray/browser/network_delegate.h"
 #include "content/public/browser/resource_request_info.h"
@@ -48,9 +51,28 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
     kOnHeadersReceived,
   };
 
+  // When enabled, events are queued on IO and the listener is called with
+  // { events: [details...], dropped } at most once per |interval|. Events
+  // beyond |max_size| are dropped and counted until the next flush.
+  struct BatchOptions {
+    BatchOptions();
+
+    bool enabled;
+    base::TimeDelta interval;
+    size_t max_size;
+  };
+
   struct SimpleListenerInfo {
     URLPatterns url_patterns;
     SimpleListener listener;
+    BatchOptions batch;
+  };
+
+  struct PendingSimpleEvent {
+    std::unique_ptr<base::DictionaryValue> details;
+    int frame_tree_node_id;
+    int render_frame_id;
+    int render_process_id;
   };
 
   struct ResponseListenerInfo {
@@ -63,11 +85,15 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
 
   void SetSimpleListenerInIO(SimpleEvent type,
                              const URLPatterns& patterns,
-                             const SimpleListener& callback);
+                             const SimpleListener& callback,
+                             const BatchOptions& batch);
   void SetResponseListenerInIO(ResponseEvent type,
                                const URLPatterns& patterns,
                                const ResponseListener& callback);
 
+  // Replaces the declarative rules, which run before any JS listener.
+  void SetRulesInIO(const WebRequestRules& rules);
+
   void SetDevToolsNetworkEmulationClientId(const std::string& client_id);
 
  protected:
@@ -108,6 +134,10 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
                           Out out,
                           Args... args);
 
+  // Batched delivery of simple events.
+  void QueueSimpleEvent(SimpleEvent type, PendingSimpleEvent event);
+  void FlushSimpleEvents(SimpleEvent type, uint64_t generation);
+
   // Deal with the results of Listener.
   template<typename T>
   void OnListenerResultInIO(
@@ -119,7 +149,13 @@ class AtomNetworkDelegate : public brightray::NetworkDelegate {
 
   std::map<SimpleEvent, SimpleListenerInfo> simple_listeners_;
   std::map<ResponseEvent, ResponseListenerInfo> response_listeners_;
+  std::map<SimpleEvent, std::vector<PendingSimpleEvent>> pending_events_;
+  std::map<SimpleEvent, size_t> dropped_events_;
+  // Bumped whenever the listener of a type is replaced, so the flush
+  // scheduled for the previous listener does nothing.
+  std::map<SimpleEvent, uint64_t> listener_generations_;
   std::map<uint64_t, net::CompletionCallback> callbacks_;
+  WebRequestRules rules_;
 
   base::Lock lock_;
 
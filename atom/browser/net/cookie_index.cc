@@ -0,0 +1,177 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/cookie_index.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/time/time.h"
+#include "net/base/registry_controlled_domains/registry_controlled_domain.h"
+#include "net/url_request/url_request_context.h"
+#include "net/url_request/url_request_context_getter.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+std::string StripLeadingDot(const std::string& domain) {
+  if (!domain.empty() && domain[0] == '.')
+    return domain.substr(1);
+  return domain;
+}
+
+// Orders cookies like CookieMonster::GetAllCookies, longest path first.
+bool CookieSorter(const net::CanonicalCookie& a,
+                  const net::CanonicalCookie& b) {
+  if (a.Path().length() != b.Path().length())
+    return a.Path().length() > b.Path().length();
+  return a.CreationDate() < b.CreationDate();
+}
+
+}  // namespace
+
+CookieIndex::CookieIndex(net::URLRequestContextGetter* request_context_getter,
+                         const ChangedCallback& changed_callback)
+    : request_context_getter_(request_context_getter),
+      changed_callback_(changed_callback),
+      notify_changes_(false),
+      state_(NOT_LOADED) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+}
+
+CookieIndex::~CookieIndex() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (subscription_)
+    OnContextShuttingDown();
+}
+
+void CookieIndex::Start() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  net::CookieStore* store = GetCookieStore();
+  if (!store)
+    return;
+
+  request_context_getter_->AddObserver(this);
+  subscription_ = store->AddCallbackForAllChanges(
+      base::Bind(&CookieIndex::OnCookieChanged, base::Unretained(this)));
+}
+
+void CookieIndex::SetNotifyChanges(bool notify_changes) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  notify_changes_ = notify_changes;
+}
+
+void CookieIndex::Query(const std::string& domain,
+                        const QueryCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (state_ == LOADED) {
+    RunQuery(domain, callback);
+    return;
+  }
+
+  pending_queries_.emplace_back(domain, callback);
+  if (state_ == LOADING)
+    return;
+
+  net::CookieStore* store = GetCookieStore();
+  if (!store) {
+    OnLoaded(net::CookieList());
+    return;
+  }
+  state_ = LOADING;
+  store->GetAllCookiesAsync(base::Bind(&CookieIndex::OnLoaded, this));
+}
+
+void CookieIndex::OnContextShuttingDown() {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  // The subscription can not outlive the cookie store.
+  subscription_.reset();
+  request_context_getter_->RemoveObserver(this);
+}
+
+// static
+std::string CookieIndex::GetKey(const std::string& domain) {
+  std::string host = StripLeadingDot(domain);
+  std::string key = net::registry_controlled_domains::GetDomainAndRegistry(
+      host, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return key.empty() ? host : key;
+}
+
+net::CookieStore* CookieIndex::GetCookieStore() const {
+  net::URLRequestContext* context =
+      request_context_getter_->GetURLRequestContext();
+  return context ? context->cookie_store() : nullptr;
+}
+
+void CookieIndex::OnLoaded(const net::CookieList& cookies) {
+  cookies_.clear();
+  for (const auto& cookie : cookies)
+    cookies_[GetKey(cookie.Domain())].push_back(cookie);
+  state_ = LOADED;
+
+  std::vector<std::pair<std::string, QueryCallback>> queries;
+  queries.swap(pending_queries_);
+  for (const auto& query : queries)
+    RunQuery(query.first, query.second);
+}
+
+void CookieIndex::RunQuery(const std::string& domain,
+                           const QueryCallback& callback) {
+  // Cookies of a registry such as "com" itself are spread over all the keys.
+  std::string host = StripLeadingDot(domain);
+  bool indexed = !net::registry_controlled_domains::GetDomainAndRegistry(
+      host, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES)
+      .empty();
+
+  // Expired cookies are only dropped from the store when it next touches
+  // them.
+  base::Time now = base::Time::Now();
+  net::CookieList result;
+  auto add_unexpired = [&](const net::CookieList& cookies) {
+    for (const auto& cookie : cookies) {
+      if (!cookie.IsExpired(now))
+        result.push_back(cookie);
+    }
+  };
+  if (indexed) {
+    auto it = cookies_.find(GetKey(host));
+    if (it != cookies_.end())
+      add_unexpired(it->second);
+  } else {
+    for (const auto& it : cookies_)
+      add_unexpired(it.second);
+  }
+
+  std::sort(result.begin(), result.end(), CookieSorter);
+  callback.Run(result);
+}
+
+void CookieIndex::OnCookieChanged(const net::CanonicalCookie& cookie,
+                                  net::CookieStore::ChangeCause cause) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  // Changes made before the index is loaded are part of what it loads.
+  if (state_ == LOADED) {
+    net::CookieList& cookies = cookies_[GetKey(cookie.Domain())];
+    auto it = std::find_if(cookies.begin(), cookies.end(),
+                           [&cookie](const net::CanonicalCookie& other) {
+                             return cookie.IsEquivalent(other);
+                           });
+    if (cause == net::CookieStore::ChangeCause::INSERTED) {
+      if (it != cookies.end())
+        *it = cookie;
+      else
+        cookies.push_back(cookie);
+    } else if (it != cookies.end()) {
+      cookies.erase(it);
+    }
+  }
+
+  if (notify_changes_)
+    changed_callback_.Run(cookie, cause);
+}
+
+}  // namespace atom
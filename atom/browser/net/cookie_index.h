@@ -0,0 +1,100 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_COOKIE_INDEX_H_
+#define ATOM_BROWSER_NET_COOKIE_INDEX_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/cookies/canonical_cookie.h"
+#include "net/cookies/cookie_store.h"
+#include "net/url_request/url_request_context_getter_observer.h"
+
+namespace net {
+class URLRequestContextGetter;
+}
+
+namespace atom {
+
+// Keeps the cookies of a request context grouped by registrable domain, the
+// way the cookie monster stores them, so the cookies of a domain can be
+// looked up without reading the whole store. The index is filled from the
+// store on the first query and then kept up to date from the store's change
+// notifications, which are also forwarded to |changed_callback| while
+// SetNotifyChanges(true) is in effect.
+//
+// Must be created on the UI thread, everything else happens on the IO
+// thread.
+class CookieIndex
+    : public base::RefCountedThreadSafe<
+          CookieIndex, content::BrowserThread::DeleteOnIOThread>,
+      public net::URLRequestContextGetterObserver {
+ public:
+  using ChangedCallback = base::Callback<void(
+      const net::CanonicalCookie&, net::CookieStore::ChangeCause)>;
+  using QueryCallback = base::Callback<void(const net::CookieList&)>;
+
+  CookieIndex(net::URLRequestContextGetter* request_context_getter,
+              const ChangedCallback& changed_callback);
+
+  // Subscribes to the store's changes.
+  void Start();
+
+  // Whether changes are forwarded to |changed_callback_|, off by default.
+  void SetNotifyChanges(bool notify_changes);
+
+  // Runs |callback| with the unexpired cookies that may match |domain|, that
+  // is those stored under the same registrable domain. All the cookies are
+  // passed when |domain| is empty or is not under a registrable domain.
+  void Query(const std::string& domain, const QueryCallback& callback);
+
+  // net::URLRequestContextGetterObserver:
+  void OnContextShuttingDown() override;
+
+ private:
+  friend struct content::BrowserThread::DeleteOnThread<
+      content::BrowserThread::IO>;
+  friend class base::DeleteHelper<CookieIndex>;
+
+  enum State {
+    NOT_LOADED,
+    LOADING,
+    LOADED,
+  };
+
+  ~CookieIndex() override;
+
+  // Returns the registrable domain the cookies of |domain| are stored under.
+  static std::string GetKey(const std::string& domain);
+
+  net::CookieStore* GetCookieStore() const;
+  void OnLoaded(const net::CookieList& cookies);
+  void RunQuery(const std::string& domain, const QueryCallback& callback);
+  void OnCookieChanged(const net::CanonicalCookie& cookie,
+                       net::CookieStore::ChangeCause cause);
+
+  scoped_refptr<net::URLRequestContextGetter> request_context_getter_;
+  ChangedCallback changed_callback_;
+  std::unique_ptr<net::CookieStore::CookieChangedSubscription> subscription_;
+  bool notify_changes_;
+
+  State state_;
+  std::map<std::string, net::CookieList> cookies_;
+  // Queries waiting for the index to be loaded.
+  std::vector<std::pair<std::string, QueryCallback>> pending_queries_;
+
+  DISALLOW_COPY_AND_ASSIGN(CookieIndex);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_COOKIE_INDEX_H_
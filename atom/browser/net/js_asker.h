@@ -8,6 +8,7 @@
 #include <memory>
 #include <utility>
 
+#include "atom/browser/net/protocol_response_cache.h"
 #include "atom/common/native_mate_converters/net_converter.h"
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
@@ -54,10 +55,12 @@ class JsAsker : public RequestJob {
   void SetHandlerInfo(
       v8::Isolate* isolate,
       net::URLRequestContextGetter* request_context_getter,
-      const JavaScriptHandler& handler) {
+      const JavaScriptHandler& handler,
+      ProtocolResponseCache* response_cache) {
     isolate_ = isolate;
     request_context_getter_ = request_context_getter;
     handler_ = handler;
+    response_cache_ = response_cache;
   }
 
   // Subclass should do initailze work here.
@@ -68,6 +71,12 @@ class JsAsker : public RequestJob {
     return request_context_getter_;
   }
 
+  // Jobs whose response can be served again without asking the handler
+  // offer it to this cache in StartAsync().
+  ProtocolResponseCache* response_cache() const {
+    return response_cache_.get();
+  }
+
  private:
   // RequestJob:
   void Start() override {
@@ -104,6 +113,7 @@ class JsAsker : public RequestJob {
   v8::Isolate* isolate_;
   net::URLRequestContextGetter* request_context_getter_;
   JavaScriptHandler handler_;
+  scoped_refptr<ProtocolResponseCache> response_cache_;
 
   base::WeakPtrFactory<JsAsker> weak_factory_;
 
@@ -0,0 +1,194 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/protocol_response_cache.h"
+
+#include <iterator>
+#include <utility>
+
+#include "atom/common/atom_constants.h"
+#include "base/values.h"
+#include "content/public/browser/browser_thread.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/http/http_response_info.h"
+#include "net/url_request/url_request.h"
+#include "net/url_request/url_request_simple_job.h"
+#include "url/gurl.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+// Memory budget of the cache, least recently used responses are dropped
+// first when it is exceeded.
+const size_t kMaxCacheSize = 32 * 1024 * 1024;
+
+class URLRequestCachedJob : public net::URLRequestSimpleJob {
+ public:
+  URLRequestCachedJob(net::URLRequest* request,
+                      net::NetworkDelegate* network_delegate,
+                      const std::string& mime_type,
+                      const std::string& charset,
+                      scoped_refptr<base::RefCountedMemory> data)
+      : net::URLRequestSimpleJob(request, network_delegate),
+        mime_type_(mime_type),
+        charset_(charset),
+        data_(data) {}
+
+  // URLRequestJob:
+  void GetResponseInfo(net::HttpResponseInfo* info) override {
+    auto* headers = new net::HttpResponseHeaders("HTTP/1.1 200 OK");
+
+    headers->AddHeader(kCORSHeader);
+
+    if (!mime_type_.empty()) {
+      std::string content_type_header(net::HttpRequestHeaders::kContentType);
+      content_type_header.append(": ");
+      content_type_header.append(mime_type_);
+      headers->AddHeader(content_type_header);
+    }
+
+    info->headers = headers;
+  }
+
+  // URLRequestSimpleJob:
+  int GetRefCountedData(
+      std::string* mime_type,
+      std::string* charset,
+      scoped_refptr<base::RefCountedMemory>* data,
+      const net::CompletionCallback& callback) const override {
+    *mime_type = mime_type_;
+    *charset = charset_;
+    *data = data_;
+    return net::OK;
+  }
+
+ private:
+  std::string mime_type_;
+  std::string charset_;
+  scoped_refptr<base::RefCountedMemory> data_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestCachedJob);
+};
+
+}  // namespace
+
+ProtocolResponseCache::Stats::Stats()
+    : hits(0), misses(0), entries(0), size(0) {
+}
+
+ProtocolResponseCache::Entry::Entry() {
+}
+
+ProtocolResponseCache::Entry::Entry(const Entry& other) = default;
+
+ProtocolResponseCache::Entry::~Entry() {
+}
+
+ProtocolResponseCache::ProtocolResponseCache()
+    : entries_(EntryMap::NO_AUTO_EVICT),
+      size_(0),
+      hits_(0),
+      misses_(0) {
+}
+
+ProtocolResponseCache::~ProtocolResponseCache() {
+}
+
+net::URLRequestJob* ProtocolResponseCache::MaybeCreateJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  if (request->method() != "GET" || entries_.empty()) {
+    ++misses_;
+    return nullptr;
+  }
+
+  auto it = entries_.Get(request->url().spec());
+  if (it == entries_.end()) {
+    ++misses_;
+    return nullptr;
+  }
+
+  const Entry& entry = it->second;
+  if (!entry.expires.is_null() && entry.expires <= base::TimeTicks::Now()) {
+    Erase(it);
+    ++misses_;
+    return nullptr;
+  }
+
+  ++hits_;
+  return new URLRequestCachedJob(request, network_delegate, entry.mime_type,
+                                 entry.charset, entry.data);
+}
+
+void ProtocolResponseCache::MaybeStore(
+    const net::URLRequest* request,
+    const base::Value& options,
+    const std::string& mime_type,
+    const std::string& charset,
+    scoped_refptr<base::RefCountedMemory> data) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  const base::DictionaryValue* dict = nullptr;
+  if (!data || request->method() != "GET" || !options.GetAsDictionary(&dict))
+    return;
+
+  bool immutable = false;
+  double max_age = 0;
+  dict->GetBoolean("immutable", &immutable);
+  dict->GetDouble("maxAge", &max_age);
+  if ((!immutable && max_age <= 0) || data->size() > kMaxCacheSize)
+    return;
+
+  Entry entry;
+  entry.mime_type = mime_type;
+  entry.charset = charset;
+  entry.data = data;
+  if (!immutable) {
+    entry.expires =
+        base::TimeTicks::Now() + base::TimeDelta::FromSecondsD(max_age);
+  }
+
+  const std::string key = request->url().spec();
+  auto it = entries_.Peek(key);
+  if (it != entries_.end())
+    Erase(it);
+  while (!entries_.empty() && size_ + data->size() > kMaxCacheSize)
+    Erase(std::prev(entries_.end()));
+
+  size_ += data->size();
+  entries_.Put(key, std::move(entry));
+}
+
+void ProtocolResponseCache::Clear(const std::string& scheme) {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (scheme.empty() || GURL(it->first).SchemeIs(scheme)) {
+      size_ -= it->second.data->size();
+      it = entries_.Erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+ProtocolResponseCache::Stats ProtocolResponseCache::GetStats() const {
+  DCHECK_CURRENTLY_ON(BrowserThread::IO);
+  Stats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.entries = entries_.size();
+  stats.size = size_;
+  return stats;
+}
+
+void ProtocolResponseCache::Erase(EntryMap::iterator it) {
+  size_ -= it->second.data->size();
+  entries_.Erase(it);
+}
+
+}  // namespace atom
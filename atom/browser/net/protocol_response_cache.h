@@ -0,0 +1,98 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+#define ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
+
+#include <stdint.h>
+
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/time/time.h"
+
+namespace base {
+class Value;
+}
+
+namespace net {
+class NetworkDelegate;
+class URLRequest;
+class URLRequestJob;
+}
+
+namespace atom {
+
+// Caches responses of JS protocol handlers by URL, so that requests for
+// content the handler marked as cacheable are answered on the IO thread
+// without asking the handler again. A response is only cached when the
+// handler returned a |maxAge| (in seconds) or |immutable| hint with it.
+//
+// All methods must be called on the IO thread.
+class ProtocolResponseCache
+    : public base::RefCountedThreadSafe<ProtocolResponseCache> {
+ public:
+  struct Stats {
+    Stats();
+
+    uint64_t hits;
+    uint64_t misses;
+    size_t entries;
+    size_t size;
+  };
+
+  ProtocolResponseCache();
+
+  // Returns a job serving the cached response for |request|, or nullptr
+  // when the request has to go to the handler.
+  net::URLRequestJob* MaybeCreateJob(net::URLRequest* request,
+                                     net::NetworkDelegate* network_delegate);
+
+  // Stores the response of |request| if |options|, as returned by the
+  // handler, has cache hints.
+  void MaybeStore(const net::URLRequest* request,
+                  const base::Value& options,
+                  const std::string& mime_type,
+                  const std::string& charset,
+                  scoped_refptr<base::RefCountedMemory> data);
+
+  // Drops the responses of |scheme|, or all of them when it is empty.
+  void Clear(const std::string& scheme);
+
+  Stats GetStats() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ProtocolResponseCache>;
+
+  struct Entry {
+    Entry();
+    Entry(const Entry& other);
+    ~Entry();
+
+    std::string mime_type;
+    std::string charset;
+    scoped_refptr<base::RefCountedMemory> data;
+    // Null for immutable responses.
+    base::TimeTicks expires;
+  };
+  using EntryMap = base::MRUCache<std::string, Entry>;
+
+  ~ProtocolResponseCache();
+
+  void Erase(EntryMap::iterator it);
+
+  EntryMap entries_;
+  size_t size_;
+  uint64_t hits_;
+  uint64_t misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProtocolResponseCache);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_PROTOCOL_RESPONSE_CACHE_H_
@@ -67,6 +67,10 @@ void URLRequestBufferJob::StartAsync(std::unique_ptr<base::Value> options) {
   data_ = new base::RefCountedBytes(
       reinterpret_cast<const unsigned char*>(blob->data()), blob->size());
   status_code_ = net::HTTP_OK;
+  if (response_cache()) {
+    response_cache()->MaybeStore(request(), *options, mime_type_, charset_,
+                                 data_);
+  }
   net::URLRequestSimpleJob::Start();
 }
 
@@ -0,0 +1,252 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/url_request_stream_job.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atom/common/api/locker.h"
+#include "atom/common/atom_constants.h"
+#include "atom/common/native_mate_converters/callback.h"
+#include "base/format_macros.h"
+#include "base/strings/stringprintf.h"
+#include "native_mate/dictionary.h"
+#include "net/base/io_buffer.h"
+#include "net/http/http_util.h"
+
+#include "atom/common/node_includes.h"
+
+using content::BrowserThread;
+
+namespace atom {
+
+namespace {
+
+using ReadCompleteCallback =
+    base::Callback<void(int, scoped_refptr<net::IOBuffer>)>;
+
+// The callback which is passed to the |read| function of the handler. The
+// chunk is copied into a buffer of its own, the one of the job is only
+// written on IO thread once the read is known to be still pending.
+void OnChunkRead(int buf_size,
+                 const ReadCompleteCallback& callback,
+                 mate::Arguments* args) {
+  // Nothing, null or an empty buffer means the end of the body.
+  int result = 0;
+  scoped_refptr<net::IOBuffer> chunk_data;
+  v8::Local<v8::Value> chunk;
+  if (args->GetNext(&chunk) && !chunk->IsNullOrUndefined()) {
+    if (node::Buffer::HasInstance(chunk)) {
+      // Reads are positional, so bytes beyond |buf_size| are simply asked for
+      // again by the next read.
+      size_t length = std::min(node::Buffer::Length(chunk),
+                               static_cast<size_t>(buf_size));
+      result = static_cast<int>(length);
+      chunk_data = new net::IOBuffer(length);
+      memcpy(chunk_data->data(), node::Buffer::Data(chunk), length);
+    } else if (!chunk->IsInt32() ||
+               !mate::ConvertFromV8(args->isolate(), chunk, &result) ||
+               result >= 0) {
+      result = net::ERR_FAILED;
+    }
+  }
+  BrowserThread::PostTask(BrowserThread::IO, FROM_HERE,
+                          base::Bind(callback, result, chunk_data));
+}
+
+// Asks the handler for the next chunk in UI thread.
+void ReadChunk(v8::Isolate* isolate,
+               const URLRequestStreamJob::ReadFunction& read,
+               int64_t offset,
+               int buf_size,
+               const ReadCompleteCallback& callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  read.Run(offset, buf_size, mate::ConvertToV8(
+      isolate, base::Bind(&OnChunkRead, buf_size, callback)));
+}
+
+}  // namespace
+
+URLRequestStreamJob::URLRequestStreamJob(
+    net::URLRequest* request, net::NetworkDelegate* network_delegate)
+    : JsAsker<net::URLRequestJob>(request, network_delegate),
+      isolate_(nullptr),
+      length_(-1),
+      range_requested_(false),
+      range_parse_result_(net::OK),
+      partial_(false),
+      offset_(0),
+      remaining_bytes_(-1),
+      read_id_(0),
+      weak_factory_(this) {
+}
+
+URLRequestStreamJob::~URLRequestStreamJob() {
+}
+
+void URLRequestStreamJob::BeforeStartInUI(
+    v8::Isolate* isolate, v8::Local<v8::Value> value) {
+  mate::Dictionary options;
+  if (!mate::ConvertFromV8(isolate, value, &options))
+    return;
+
+  isolate_ = isolate;
+  options.Get("read", &read_);
+}
+
+void URLRequestStreamJob::StartAsync(std::unique_ptr<base::Value> options) {
+  if (!options->is_dict() || read_.is_null()) {
+    NotifyStartError(net::URLRequestStatus(
+          net::URLRequestStatus::FAILED, net::ERR_NOT_IMPLEMENTED));
+    return;
+  }
+
+  base::DictionaryValue* dict =
+      static_cast<base::DictionaryValue*>(options.get());
+  dict->GetString("mimeType", &mime_type_);
+  dict->GetString("charset", &charset_);
+  double length = -1;
+  dict->GetDouble("length", &length);
+  base::DictionaryValue* headers = nullptr;
+  if (dict->GetDictionary("headers", &headers)) {
+    for (base::DictionaryValue::Iterator it(*headers); !it.IsAtEnd();
+         it.Advance()) {
+      std::string value;
+      if (it.value().GetAsString(&value))
+        headers_.push_back(std::make_pair(it.key(), value));
+    }
+  }
+
+  if (length >= 0) {
+    if (range_parse_result_ != net::OK) {
+      NotifyStartError(net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                             range_parse_result_));
+      return;
+    }
+    if (!byte_range_.ComputeBounds(static_cast<int64_t>(length))) {
+      NotifyStartError(
+          net::URLRequestStatus(net::URLRequestStatus::FAILED,
+                                net::ERR_REQUEST_RANGE_NOT_SATISFIABLE));
+      return;
+    }
+    length_ = static_cast<int64_t>(length);
+    partial_ = range_requested_;
+    offset_ = byte_range_.first_byte_position();
+    remaining_bytes_ = byte_range_.last_byte_position() - offset_ + 1;
+    set_expected_content_size(remaining_bytes_);
+  }
+
+  NotifyHeadersComplete();
+}
+
+void URLRequestStreamJob::Kill() {
+  weak_factory_.InvalidateWeakPtrs();
+  read_buffer_ = nullptr;
+  URLRequestJob::Kill();
+}
+
+int URLRequestStreamJob::ReadRawData(net::IOBuffer* buf, int buf_size) {
+  DCHECK(!read_buffer_);
+  if (remaining_bytes_ >= 0 && remaining_bytes_ < buf_size)
+    buf_size = static_cast<int>(remaining_bytes_);
+  if (!buf_size)
+    return 0;
+
+  read_buffer_ = buf;
+  BrowserThread::PostTask(
+      BrowserThread::UI, FROM_HERE,
+      base::Bind(&ReadChunk, isolate_, read_, offset_, buf_size,
+                 base::Bind(&URLRequestStreamJob::DidRead,
+                            weak_factory_.GetWeakPtr(), ++read_id_)));
+  return net::ERR_IO_PENDING;
+}
+
+void URLRequestStreamJob::DidRead(uint32_t read_id,
+                                  int result,
+                                  scoped_refptr<net::IOBuffer> chunk_data) {
+  // The handler may call back more than once for the same chunk.
+  if (!read_buffer_ || read_id != read_id_)
+    return;
+
+  scoped_refptr<net::IOBuffer> buffer = std::move(read_buffer_);
+  if (result > 0) {
+    memcpy(buffer->data(), chunk_data->data(), result);
+    offset_ += result;
+    if (remaining_bytes_ >= 0)
+      remaining_bytes_ -= result;
+  } else if (result == 0 && remaining_bytes_ > 0) {
+    // The body ended before the announced length.
+    result = net::ERR_CONTENT_LENGTH_MISMATCH;
+  }
+  ReadRawDataComplete(result);
+}
+
+bool URLRequestStreamJob::GetMimeType(std::string* mime_type) const {
+  *mime_type = mime_type_;
+  return !mime_type_.empty();
+}
+
+bool URLRequestStreamJob::GetCharset(std::string* charset) {
+  *charset = charset_;
+  return !charset_.empty();
+}
+
+void URLRequestStreamJob::SetExtraRequestHeaders(
+    const net::HttpRequestHeaders& headers) {
+  std::string range_header;
+  if (headers.GetHeader(net::HttpRequestHeaders::kRange, &range_header)) {
+    // Validated in StartAsync(), once the size of the body is known.
+    std::vector<net::HttpByteRange> ranges;
+    if (net::HttpUtil::ParseRangeHeader(range_header, &ranges)) {
+      if (ranges.size() == 1) {
+        byte_range_ = ranges[0];
+        range_requested_ = true;
+      } else {
+        range_parse_result_ = net::ERR_REQUEST_RANGE_NOT_SATISFIABLE;
+      }
+    }
+  }
+}
+
+void URLRequestStreamJob::GetResponseInfo(net::HttpResponseInfo* info) {
+  std::string status(partial_ ? "HTTP/1.1 206 Partial Content"
+                              : "HTTP/1.1 200 OK");
+  auto* headers = new net::HttpResponseHeaders(status);
+
+  headers->AddHeader(kCORSHeader);
+
+  if (!mime_type_.empty()) {
+    std::string content_type_header(net::HttpRequestHeaders::kContentType);
+    content_type_header.append(": ");
+    content_type_header.append(mime_type_);
+    headers->AddHeader(content_type_header);
+  }
+
+  if (length_ >= 0) {
+    headers->AddHeader("Accept-Ranges: bytes");
+    headers->AddHeader(base::StringPrintf(
+        "%s: %" PRId64, net::HttpRequestHeaders::kContentLength,
+        byte_range_.last_byte_position() - byte_range_.first_byte_position() +
+            1));
+    if (partial_) {
+      headers->AddHeader(base::StringPrintf(
+          "Content-Range: bytes %" PRId64 "-%" PRId64 "/%" PRId64,
+          byte_range_.first_byte_position(), byte_range_.last_byte_position(),
+          length_));
+    }
+  }
+
+  for (const auto& header : headers_)
+    headers->AddHeader(header.first + ": " + header.second);
+
+  info->headers = headers;
+}
+
+}  // namespace atom
@@ -0,0 +1,83 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+#define ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "atom/browser/net/js_asker.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "net/http/http_byte_range.h"
+#include "net/url_request/url_request_job.h"
+
+namespace atom {
+
+// Serves the response of a JS protocol handler in chunks. Instead of the
+// whole body the handler passes a |read(offset, size, callback)| function,
+// which is asked for the next chunk every time the network stack has room
+// for it, so the body is never held in memory as a whole.
+class URLRequestStreamJob : public JsAsker<net::URLRequestJob> {
+ public:
+  using ReadFunction =
+      base::Callback<void(int64_t, int, v8::Local<v8::Value>)>;
+
+  URLRequestStreamJob(net::URLRequest*, net::NetworkDelegate*);
+  ~URLRequestStreamJob() override;
+
+  // JsAsker:
+  void BeforeStartInUI(v8::Isolate*, v8::Local<v8::Value>) override;
+  void StartAsync(std::unique_ptr<base::Value> options) override;
+
+  // URLRequestJob:
+  void Kill() override;
+  int ReadRawData(net::IOBuffer* buf, int buf_size) override;
+  bool GetMimeType(std::string* mime_type) const override;
+  bool GetCharset(std::string* charset) override;
+  void SetExtraRequestHeaders(const net::HttpRequestHeaders& headers) override;
+  void GetResponseInfo(net::HttpResponseInfo* info) override;
+
+ private:
+  // Called on IO thread when the handler has answered the read identified by
+  // |read_id| with |result| bytes of |chunk_data|, or failed with a net error.
+  void DidRead(uint32_t read_id,
+               int result,
+               scoped_refptr<net::IOBuffer> chunk_data);
+
+  v8::Isolate* isolate_;
+  ReadFunction read_;
+
+  std::string mime_type_;
+  std::string charset_;
+  std::vector<std::pair<std::string, std::string>> headers_;
+
+  // Total size of the body, or -1 when the handler did not tell it. Range
+  // requests are only honored when the size is known.
+  int64_t length_;
+  net::HttpByteRange byte_range_;
+  bool range_requested_;
+  net::Error range_parse_result_;
+  bool partial_;
+
+  // Offset of the next byte to read, and how many bytes are left (or -1 when
+  // reading until the handler signals the end).
+  int64_t offset_;
+  int64_t remaining_bytes_;
+
+  // Buffer of the pending read, null when there is none.
+  scoped_refptr<net::IOBuffer> read_buffer_;
+  uint32_t read_id_;
+
+  base::WeakPtrFactory<URLRequestStreamJob> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(URLRequestStreamJob);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_URL_REQUEST_STREAM_JOB_H_
@@ -14,7 +14,8 @@ namespace atom {
 
 URLRequestStringJob::URLRequestStringJob(
     net::URLRequest* request, net::NetworkDelegate* network_delegate)
-    : JsAsker<net::URLRequestSimpleJob>(request, network_delegate) {
+    : JsAsker<net::URLRequestSimpleJob>(request, network_delegate),
+      data_(new base::RefCountedString) {
 }
 
 void URLRequestStringJob::StartAsync(std::unique_ptr<base::Value> options) {
@@ -23,9 +24,13 @@ void URLRequestStringJob::StartAsync(std::unique_ptr<base::Value> options) {
         static_cast<base::DictionaryValue*>(options.get());
     dict->GetString("mimeType", &mime_type_);
     dict->GetString("charset", &charset_);
-    dict->GetString("data", &data_);
+    dict->GetString("data", &data_->data());
   } else if (options->is_string()) {
-    options->GetAsString(&data_);
+    options->GetAsString(&data_->data());
+  }
+  if (response_cache()) {
+    response_cache()->MaybeStore(request(), *options, mime_type_, charset_,
+                                 data_);
   }
   net::URLRequestSimpleJob::Start();
 }
@@ -46,10 +51,10 @@ void URLRequestStringJob::GetResponseInfo(net::HttpResponseInfo* info) {
   info->headers = headers;
 }
 
-int URLRequestStringJob::GetData(
+int URLRequestStringJob::GetRefCountedData(
     std::string* mime_type,
     std::string* charset,
-    std::string* data,
+    scoped_refptr<base::RefCountedMemory>* data,
     const net::CompletionCallback& callback) const {
   *mime_type = mime_type_;
   *charset = charset_;
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "atom/browser/net/js_asker.h"
+#include "base/memory/ref_counted_memory.h"
 #include "net/url_request/url_request_simple_job.h"
 
 namespace atom {
@@ -24,15 +25,15 @@ class URLRequestStringJob : public JsAsker<net::URLRequestSimpleJob> {
   void GetResponseInfo(net::HttpResponseInfo* info) override;
 
   // URLRequestSimpleJob:
-  int GetData(std::string* mime_type,
-              std::string* charset,
-              std::string* data,
-              const net::CompletionCallback& callback) const override;
+  int GetRefCountedData(std::string* mime_type,
+                        std::string* charset,
+                        scoped_refptr<base::RefCountedMemory>* data,
+                        const net::CompletionCallback& callback) const override;
 
  private:
   std::string mime_type_;
   std::string charset_;
-  std::string data_;
+  scoped_refptr<base::RefCountedString> data_;
 
   DISALLOW_COPY_AND_ASSIGN(URLRequestStringJob);
 };
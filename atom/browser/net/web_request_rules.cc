@@ -0,0 +1,229 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/net/web_request_rules.h"
+
+#include "atom/browser/net/atom_network_delegate.h"
+#include "base/values.h"
+#include "content/public/browser/resource_request_info.h"
+#include "net/base/net_errors.h"
+#include "net/http/http_request_headers.h"
+#include "net/http/http_response_headers.h"
+#include "net/url_request/url_request.h"
+
+namespace atom {
+
+namespace {
+
+bool ReadStringList(const base::DictionaryValue& dict,
+                    const std::string& key,
+                    std::vector<std::string>* out) {
+  const base::ListValue* list = nullptr;
+  if (!dict.GetList(key, &list))
+    return !dict.HasKey(key);
+
+  for (const auto& item : *list) {
+    std::string value;
+    if (!item.GetAsString(&value))
+      return false;
+    out->push_back(value);
+  }
+  return true;
+}
+
+bool ReadStringMap(const base::DictionaryValue& dict,
+                   const std::string& key,
+                   std::map<std::string, std::string>* out) {
+  const base::DictionaryValue* map = nullptr;
+  if (!dict.GetDictionary(key, &map))
+    return !dict.HasKey(key);
+
+  for (base::DictionaryValue::Iterator it(*map); !it.IsAtEnd(); it.Advance()) {
+    std::string value;
+    if (!it.value().GetAsString(&value))
+      return false;
+    (*out)[it.key()] = value;
+  }
+  return true;
+}
+
+bool ParseRule(const base::DictionaryValue& dict,
+               WebRequestRule* rule,
+               std::string* error) {
+  std::vector<std::string> urls;
+  if (!ReadStringList(dict, "urls", &urls)) {
+    *error = "`urls` must be an array of strings";
+    return false;
+  }
+  for (const auto& url : urls) {
+    URLPattern pattern(URLPattern::SCHEME_ALL);
+    if (pattern.Parse(url) != URLPattern::PARSE_SUCCESS) {
+      *error = "Invalid url pattern " + url;
+      return false;
+    }
+    rule->url_patterns.insert(pattern);
+  }
+
+  std::vector<std::string> resource_types;
+  if (!ReadStringList(dict, "resourceTypes", &resource_types)) {
+    *error = "`resourceTypes` must be an array of strings";
+    return false;
+  }
+  rule->resource_types.insert(resource_types.begin(), resource_types.end());
+
+  std::string action;
+  if (dict.GetString("action", &action)) {
+    if (action == "block") {
+      rule->action = WebRequestRule::ACTION_BLOCK;
+    } else if (action == "redirect") {
+      std::string redirect_url;
+      dict.GetString("redirectURL", &redirect_url);
+      rule->redirect_url = GURL(redirect_url);
+      if (!rule->redirect_url.is_valid()) {
+        *error = "`redirectURL` is required for redirect rules";
+        return false;
+      }
+      rule->action = WebRequestRule::ACTION_REDIRECT;
+    } else {
+      *error = "Unknown action " + action;
+      return false;
+    }
+  }
+
+  if (!ReadStringMap(dict, "setRequestHeaders", &rule->set_request_headers) ||
+      !ReadStringList(dict, "removeRequestHeaders",
+                      &rule->remove_request_headers) ||
+      !ReadStringMap(dict, "setResponseHeaders",
+                     &rule->set_response_headers) ||
+      !ReadStringList(dict, "removeResponseHeaders",
+                      &rule->remove_response_headers)) {
+    *error = "Invalid header modifications";
+    return false;
+  }
+  return true;
+}
+
+bool MatchesRule(const WebRequestRule& rule, net::URLRequest* request) {
+  if (!rule.resource_types.empty()) {
+    auto info = content::ResourceRequestInfo::ForRequest(request);
+    std::string resource_type =
+        info ? ResourceTypeToString(info->GetResourceType()) : "other";
+    if (rule.resource_types.find(resource_type) == rule.resource_types.end())
+      return false;
+  }
+
+  if (rule.url_patterns.empty())
+    return true;
+
+  for (const auto& pattern : rule.url_patterns) {
+    if (pattern.MatchesURL(request->url()))
+      return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+WebRequestRule::WebRequestRule() : action(ACTION_NONE) {
+}
+
+WebRequestRule::WebRequestRule(const WebRequestRule& other) = default;
+
+WebRequestRule::~WebRequestRule() {
+}
+
+bool ParseWebRequestRules(const base::ListValue& list,
+                          WebRequestRules* rules,
+                          std::string* error) {
+  for (const auto& item : list) {
+    const base::DictionaryValue* dict = nullptr;
+    if (!item.GetAsDictionary(&dict)) {
+      *error = "Rules must be objects";
+      return false;
+    }
+
+    WebRequestRule rule;
+    if (!ParseRule(*dict, &rule, error))
+      return false;
+    rules->push_back(rule);
+  }
+  return true;
+}
+
+bool ApplyBeforeRequestRules(const WebRequestRules& rules,
+                             net::URLRequest* request,
+                             GURL* new_url,
+                             int* result) {
+  for (const auto& rule : rules) {
+    if (rule.action == WebRequestRule::ACTION_NONE ||
+        !MatchesRule(rule, request))
+      continue;
+
+    if (rule.action == WebRequestRule::ACTION_BLOCK) {
+      *result = net::ERR_BLOCKED_BY_CLIENT;
+      return true;
+    }
+
+    // Don't redirect a request to itself over and over.
+    if (rule.redirect_url == request->url())
+      continue;
+    *new_url = rule.redirect_url;
+    *result = net::OK;
+    return true;
+  }
+  return false;
+}
+
+void ApplyRequestHeaderRules(const WebRequestRules& rules,
+                             net::URLRequest* request,
+                             net::HttpRequestHeaders* headers) {
+  for (const auto& rule : rules) {
+    if ((rule.set_request_headers.empty() &&
+         rule.remove_request_headers.empty()) ||
+        !MatchesRule(rule, request))
+      continue;
+
+    for (const auto& name : rule.remove_request_headers)
+      headers->RemoveHeader(name);
+    for (const auto& header : rule.set_request_headers)
+      headers->SetHeader(header.first, header.second);
+  }
+}
+
+bool ApplyResponseHeaderRules(
+    const WebRequestRules& rules,
+    net::URLRequest* request,
+    const net::HttpResponseHeaders* original_headers,
+    scoped_refptr<net::HttpResponseHeaders>* override_headers) {
+  if (!original_headers)
+    return false;
+
+  scoped_refptr<net::HttpResponseHeaders> headers;
+  for (const auto& rule : rules) {
+    if ((rule.set_response_headers.empty() &&
+         rule.remove_response_headers.empty()) ||
+        !MatchesRule(rule, request))
+      continue;
+
+    // Build on top of whatever another delegate already changed.
+    if (!headers) {
+      headers = new net::HttpResponseHeaders(override_headers->get() ?
+          (*override_headers)->raw_headers() : original_headers->raw_headers());
+    }
+
+    for (const auto& name : rule.remove_response_headers)
+      headers->RemoveHeader(name);
+    for (const auto& header : rule.set_response_headers) {
+      headers->RemoveHeader(header.first);
+      headers->AddHeader(header.first + ": " + header.second);
+    }
+  }
+
+  if (!headers)
+    return false;
+  *override_headers = headers;
+  return true;
+}
+
+}  // namespace atom
@@ -0,0 +1,81 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+#define ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "extensions/common/url_pattern.h"
+#include "url/gurl.h"
+
+namespace base {
+class ListValue;
+}
+
+namespace net {
+class HttpRequestHeaders;
+class HttpResponseHeaders;
+class URLRequest;
+}
+
+namespace atom {
+
+// A declarative webRequest rule. Rules are evaluated synchronously on the IO
+// thread so requests they match never wait on a JS listener.
+struct WebRequestRule {
+  enum Action {
+    ACTION_NONE,
+    ACTION_BLOCK,
+    ACTION_REDIRECT,
+  };
+
+  WebRequestRule();
+  WebRequestRule(const WebRequestRule& other);
+  ~WebRequestRule();
+
+  // Conditions, empty sets match everything.
+  std::set<URLPattern> url_patterns;
+  std::set<std::string> resource_types;
+
+  Action action;
+  GURL redirect_url;
+  std::map<std::string, std::string> set_request_headers;
+  std::vector<std::string> remove_request_headers;
+  std::map<std::string, std::string> set_response_headers;
+  std::vector<std::string> remove_response_headers;
+};
+
+using WebRequestRules = std::vector<WebRequestRule>;
+
+// Parses the rules passed to webRequest.setDeclarativeRules.
+bool ParseWebRequestRules(const base::ListValue& list,
+                          WebRequestRules* rules,
+                          std::string* error);
+
+// Returns true when a block or redirect rule handled |request|, |result| is
+// the net error to return and |new_url| is set for redirects.
+bool ApplyBeforeRequestRules(const WebRequestRules& rules,
+                             net::URLRequest* request,
+                             GURL* new_url,
+                             int* result);
+
+void ApplyRequestHeaderRules(const WebRequestRules& rules,
+                             net::URLRequest* request,
+                             net::HttpRequestHeaders* headers);
+
+// Returns true when |override_headers| was set to modified headers.
+bool ApplyResponseHeaderRules(
+    const WebRequestRules& rules,
+    net::URLRequest* request,
+    const net::HttpResponseHeaders* original_headers,
+    scoped_refptr<net::HttpResponseHeaders>* override_headers);
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_NET_WEB_REQUEST_RULES_H_
@@ -0,0 +1,238 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/browser/thumbnail_tab_helper.h"
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/lazy_instance.h"
+#include "base/task_scheduler/post_task.h"
+#include "content/public/browser/browser_thread.h"
+#include "content/public/browser/render_widget_host_view.h"
+#include "content/public/browser/web_contents.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/display/display.h"
+#include "ui/display/screen.h"
+#include "ui/gfx/codec/jpeg_codec.h"
+#include "ui/gfx/geometry/size_conversions.h"
+
+DEFINE_WEB_CONTENTS_USER_DATA_KEY(atom::ThumbnailTabHelper);
+
+namespace atom {
+
+namespace {
+
+// Memory budget shared by the thumbnails of all tabs.
+const size_t kMaxStoreSize = 16 * 1024 * 1024;
+
+// Encoded thumbnails of all tabs, keyed by ThumbnailTabHelper. Only used on
+// the UI thread.
+class ThumbnailStore {
+ public:
+  ThumbnailStore() : entries_(Entries::NO_AUTO_EVICT), size_(0) {}
+
+  void Put(int key, scoped_refptr<base::RefCountedMemory> data) {
+    Remove(key);
+    while (!entries_.empty() && size_ + data->size() > kMaxStoreSize)
+      Erase(std::prev(entries_.end()));
+    size_ += data->size();
+    entries_.Put(key, data);
+  }
+
+  scoped_refptr<base::RefCountedMemory> Get(int key) {
+    auto it = entries_.Get(key);
+    return it == entries_.end() ? nullptr : it->second;
+  }
+
+  void Remove(int key) {
+    auto it = entries_.Peek(key);
+    if (it != entries_.end())
+      Erase(it);
+  }
+
+ private:
+  using Entries = base::MRUCache<int, scoped_refptr<base::RefCountedMemory>>;
+
+  void Erase(Entries::iterator it) {
+    size_ -= it->second->size();
+    entries_.Erase(it);
+  }
+
+  Entries entries_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThumbnailStore);
+};
+
+base::LazyInstance<ThumbnailStore>::Leaky g_thumbnail_store =
+    LAZY_INSTANCE_INITIALIZER;
+
+int g_next_key = 0;
+
+scoped_refptr<base::RefCountedMemory> EncodeThumbnail(const SkBitmap& bitmap,
+                                                      int quality) {
+  std::vector<unsigned char> output;
+  if (!gfx::JPEGCodec::Encode(bitmap, quality, &output))
+    return nullptr;
+  return base::RefCountedBytes::TakeVector(&output);
+}
+
+}  // namespace
+
+ThumbnailTabHelper::Options::Options()
+    : size(320, 200),
+      min_interval(base::TimeDelta::FromSeconds(1)),
+      quality(80),
+      force(false) {
+}
+
+ThumbnailTabHelper::Thumbnail::Thumbnail() : id(0) {
+}
+
+ThumbnailTabHelper::ThumbnailTabHelper(content::WebContents* web_contents)
+    : content::WebContentsObserver(web_contents),
+      key_(++g_next_key),
+      dirty_(true),
+      capturing_(false),
+      weak_factory_(this) {
+}
+
+ThumbnailTabHelper::~ThumbnailTabHelper() {
+  g_thumbnail_store.Get().Remove(key_);
+}
+
+void ThumbnailTabHelper::Capture(const Options& options,
+                                 const CaptureCallback& callback) {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  pending_callbacks_.push_back(callback);
+  if (capturing_)
+    return;
+
+  // Reuse the last thumbnail while it is still in the store and either the
+  // page did not change or it was captured too recently.
+  bool has_data = GetThumbnailData() != nullptr;
+  bool too_soon =
+      base::TimeTicks::Now() - last_capture_ < options.min_interval;
+  if (has_data && !options.force && (!dirty_ || too_soon)) {
+    RunCallbacks();
+    return;
+  }
+
+  auto* view = web_contents()->GetRenderWidgetHostView();
+  if (!view || !view->IsSurfaceAvailableForCopy() ||
+      options.size.IsEmpty()) {
+    RunCallbacks();
+    return;
+  }
+
+  // Let the compositor scale the page down to fit in |options.size|, but
+  // never beyond its size in pixels.
+  gfx::Size view_size = view->GetViewBounds().size();
+  if (view_size.IsEmpty()) {
+    RunCallbacks();
+    return;
+  }
+  float device_scale = display::Screen::GetScreen()->GetDisplayNearestView(
+      view->GetNativeView()).device_scale_factor();
+  float scale = std::min(
+      {static_cast<float>(options.size.width()) / view_size.width(),
+       static_cast<float>(options.size.height()) / view_size.height(),
+       device_scale});
+  gfx::Size output_size = gfx::ScaleToFlooredSize(view_size, scale);
+  output_size.SetToMax(gfx::Size(1, 1));
+
+  capturing_ = true;
+  dirty_ = false;
+  last_capture_ = base::TimeTicks::Now();
+  view->CopyFromSurface(gfx::Rect(view_size), output_size,
+                        base::Bind(&ThumbnailTabHelper::OnCopied,
+                                   weak_factory_.GetWeakPtr(),
+                                   options.quality),
+                        kN32_SkColorType);
+}
+
+scoped_refptr<base::RefCountedMemory> ThumbnailTabHelper::GetThumbnailData() {
+  if (!thumbnail_.id)
+    return nullptr;
+  return g_thumbnail_store.Get().Get(key_);
+}
+
+void ThumbnailTabHelper::OnCopied(int quality,
+                                  const SkBitmap& bitmap,
+                                  content::ReadbackResponse response) {
+  if (response != content::READBACK_SUCCESS) {
+    capturing_ = false;
+    dirty_ = true;
+    RunCallbacks();
+    return;
+  }
+
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::Bind(&EncodeThumbnail, bitmap, quality),
+      base::Bind(&ThumbnailTabHelper::OnEncoded, weak_factory_.GetWeakPtr(),
+                 gfx::Size(bitmap.width(), bitmap.height())));
+}
+
+void ThumbnailTabHelper::OnEncoded(
+    const gfx::Size& size, scoped_refptr<base::RefCountedMemory> data) {
+  capturing_ = false;
+  if (data) {
+    g_thumbnail_store.Get().Put(key_, data);
+    ++thumbnail_.id;
+    thumbnail_.size = size;
+    thumbnail_.captured_at = base::Time::Now();
+  } else {
+    dirty_ = true;
+  }
+  RunCallbacks();
+}
+
+void ThumbnailTabHelper::RunCallbacks() {
+  // The thumbnail may have been dropped from the store.
+  Thumbnail thumbnail;
+  if (GetThumbnailData())
+    thumbnail = thumbnail_;
+
+  std::vector<CaptureCallback> callbacks;
+  callbacks.swap(pending_callbacks_);
+  for (const auto& callback : callbacks)
+    callback.Run(thumbnail);
+}
+
+void ThumbnailTabHelper::MarkDirty() {
+  dirty_ = true;
+}
+
+void ThumbnailTabHelper::DidFirstVisuallyNonEmptyPaint() {
+  MarkDirty();
+}
+
+void ThumbnailTabHelper::DidFinishLoad(
+    content::RenderFrameHost* render_frame_host,
+    const GURL& validated_url) {
+  MarkDirty();
+}
+
+void ThumbnailTabHelper::DocumentOnLoadCompletedInMainFrame() {
+  MarkDirty();
+}
+
+void ThumbnailTabHelper::DidGetUserInteraction(
+    const blink::WebInputEvent::Type type) {
+  MarkDirty();
+}
+
+void ThumbnailTabHelper::MainFrameWasResized(bool width_changed) {
+  MarkDirty();
+}
+
+void ThumbnailTabHelper::WasShown() {
+  MarkDirty();
+}
+
+}  // namespace atom
@@ -0,0 +1,103 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_BROWSER_THUMBNAIL_TAB_HELPER_H_
+#define ATOM_BROWSER_THUMBNAIL_TAB_HELPER_H_
+
+#include <vector>
+
+#include "base/callback.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "content/public/browser/readback_types.h"
+#include "content/public/browser/web_contents_observer.h"
+#include "content/public/browser/web_contents_user_data.h"
+#include "ui/gfx/geometry/size.h"
+
+class SkBitmap;
+
+namespace atom {
+
+// Captures small JPEG thumbnails of a WebContents. The page is scaled down
+// by the compositor while it is read back, captures are rate limited and
+// skipped while the page has not changed, and the encoded thumbnails of all
+// tabs share a memory budget in which the least recently used are dropped.
+class ThumbnailTabHelper
+    : public content::WebContentsObserver,
+      public content::WebContentsUserData<ThumbnailTabHelper> {
+ public:
+  struct Options {
+    Options();
+
+    // Bounds the thumbnail is scaled to fit in, in pixels.
+    gfx::Size size;
+    // Captures closer together than this return the last thumbnail.
+    base::TimeDelta min_interval;
+    int quality;
+    // Capture even if the page did not change.
+    bool force;
+  };
+
+  // Describes the current thumbnail, the data itself is fetched separately
+  // with GetThumbnailData().
+  struct Thumbnail {
+    Thumbnail();
+
+    // Increases with every capture, 0 when there is no thumbnail.
+    int id;
+    gfx::Size size;
+    base::Time captured_at;
+  };
+
+  using CaptureCallback = base::Callback<void(const Thumbnail&)>;
+
+  ~ThumbnailTabHelper() override;
+
+  void Capture(const Options& options, const CaptureCallback& callback);
+
+  // Returns the encoded thumbnail, or nullptr when there is none or it has
+  // been dropped to stay within the memory budget.
+  scoped_refptr<base::RefCountedMemory> GetThumbnailData();
+
+ private:
+  explicit ThumbnailTabHelper(content::WebContents* web_contents);
+  friend class content::WebContentsUserData<ThumbnailTabHelper>;
+
+  void OnCopied(int quality,
+                const SkBitmap& bitmap,
+                content::ReadbackResponse response);
+  void OnEncoded(const gfx::Size& size,
+                 scoped_refptr<base::RefCountedMemory> data);
+  void RunCallbacks();
+  void MarkDirty();
+
+  // content::WebContentsObserver:
+  void DidFirstVisuallyNonEmptyPaint() override;
+  void DidFinishLoad(content::RenderFrameHost* render_frame_host,
+                     const GURL& validated_url) override;
+  void DocumentOnLoadCompletedInMainFrame() override;
+  void DidGetUserInteraction(const blink::WebInputEvent::Type type) override;
+  void MainFrameWasResized(bool width_changed) override;
+  void WasShown() override;
+
+  // Key of the thumbnail in the shared store.
+  const int key_;
+
+  Thumbnail thumbnail_;
+  // Set by events that may have changed what the page shows.
+  bool dirty_;
+  base::TimeTicks last_capture_;
+
+  bool capturing_;
+  std::vector<CaptureCallback> pending_callbacks_;
+
+  base::WeakPtrFactory<ThumbnailTabHelper> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(ThumbnailTabHelper);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_BROWSER_THUMBNAIL_TAB_HELPER_H_
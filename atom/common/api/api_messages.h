@@ -40,8 +40,19 @@ IPC_MESSAGE_ROUTED2(AtomViewMsg_Message_Shared,
 // Update renderer process preferences.
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdatePreferences, base::ListValue)
 
-// Update renderer content settings
-IPC_MESSAGE_CONTROL1(AtomMsg_UpdateContentSettings, base::DictionaryValue)
+// Update renderer content settings, the handle is a read-only
+// atom::ContentSettingsSnapshot shared by all renderers of a browser context.
+IPC_MESSAGE_CONTROL3(AtomMsg_UpdateContentSettings,
+                     uint64_t /* version */,
+                     base::SharedMemoryHandle /* snapshot */,
+                     uint32_t /* snapshot_size */)
+
+// Update renderer content settings from |base_version| to |version|, each op
+// is { op: "add" | "replace" | "remove", contentType, rules }.
+IPC_MESSAGE_CONTROL3(AtomMsg_UpdateContentSettingsDelta,
+                     uint64_t /* base_version */,
+                     uint64_t /* version */,
+                     base::ListValue /* ops */)
 
 // Update renderer content settings
 IPC_MESSAGE_CONTROL1(AtomMsg_UpdateWebKitPrefs, content::WebPreferences)
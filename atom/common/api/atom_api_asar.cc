@@ -9,6 +9,7 @@
 #include "atom_natives.h"  // NOLINT: This file is generated with coffee2c.
 
 #include "atom/common/asar/archive.h"
+#include "atom/common/asar/asar_util.h"
 #include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/node_includes.h"
@@ -153,11 +154,21 @@ void InitAsarSupport(v8::Isolate* isolate,
   }
 }
 
+v8::Local<v8::Value> GetArchiveRegistryStats(v8::Isolate* isolate) {
+  asar::ArchiveRegistryStats stats = asar::GetArchiveRegistryStats();
+  mate::Dictionary dict(isolate, v8::Object::New(isolate));
+  dict.Set("hits", stats.hits);
+  dict.Set("misses", stats.misses);
+  dict.Set("openArchives", static_cast<uint32_t>(stats.open_archives));
+  return dict.GetHandle();
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
   dict.SetMethod("createArchive", &Archive::Create);
   dict.SetMethod("initAsarSupport", &InitAsarSupport);
+  dict.SetMethod("getArchiveRegistryStats", &GetArchiveRegistryStats);
 }
 
 }  // namespace
@@ -9,7 +9,9 @@
 
 #include "atom/common/api/atom_api_native_image.h"
 
+#include "atom/common/api/locker.h"
 #include "atom/common/asar/asar_util.h"
+#include "atom/common/native_mate_converters/callback.h"
 #include "atom/common/native_mate_converters/file_path_converter.h"
 #include "atom/common/native_mate_converters/gfx_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
@@ -17,15 +19,19 @@
 #include "base/files/file_util.h"
 #include "base/strings/pattern.h"
 #include "base/strings/string_util.h"
+#include "base/task_scheduler/post_task.h"
 #include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 #include "net/base/data_url.h"
+#include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
 #include "ui/base/layout.h"
 #include "ui/gfx/codec/jpeg_codec.h"
 #include "ui/gfx/codec/png_codec.h"
+#include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/image/image_skia.h"
+#include "ui/gfx/image/image_skia_operations.h"
 #include "ui/gfx/image/image_util.h"
 
 #if defined(OS_WIN)
@@ -44,6 +50,14 @@ namespace api {
 
 namespace {
 
+using ImageReps = std::vector<gfx::ImageSkiaRep>;
+using EncodeCallback = base::Callback<void(v8::Local<v8::Value>)>;
+
+enum EncodeFormat {
+  ENCODE_PNG,
+  ENCODE_JPEG,
+};
+
 struct ScaleFactorPair {
   const char* name;
   float scale;
@@ -78,7 +92,7 @@ float GetScaleFactorFromPath(const base::FilePath& path) {
   return 1.0f;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
+bool AddImageSkiaRep(ImageReps* reps,
                      const unsigned char* data,
                      size_t size,
                      double scale_factor) {
@@ -92,11 +106,11 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   if (!decoded)
     return false;
 
-  image->AddRepresentation(gfx::ImageSkiaRep(*decoded, scale_factor));
+  reps->push_back(gfx::ImageSkiaRep(*decoded, scale_factor));
   return true;
 }
 
-bool AddImageSkiaRep(gfx::ImageSkia* image,
+bool AddImageSkiaRep(ImageReps* reps,
                      const base::FilePath& path,
                      double scale_factor) {
   std::string file_contents;
@@ -109,26 +123,147 @@ bool AddImageSkiaRep(gfx::ImageSkia* image,
   const unsigned char* data =
       reinterpret_cast<const unsigned char*>(file_contents.data());
   size_t size = file_contents.size();
-  return AddImageSkiaRep(image, data, size, scale_factor);
+  return AddImageSkiaRep(reps, data, size, scale_factor);
 }
 
-bool PopulateImageSkiaRepsFromPath(gfx::ImageSkia* image,
+bool PopulateImageSkiaRepsFromPath(ImageReps* reps,
                                    const base::FilePath& path) {
   bool succeed = false;
   std::string filename(path.BaseName().RemoveExtension().AsUTF8Unsafe());
   if (base::MatchPattern(filename, "*@*x"))
     // Don't search for other representations if the DPI has been specified.
-    return AddImageSkiaRep(image, path, GetScaleFactorFromPath(path));
+    return AddImageSkiaRep(reps, path, GetScaleFactorFromPath(path));
   else
-    succeed |= AddImageSkiaRep(image, path, 1.0f);
+    succeed |= AddImageSkiaRep(reps, path, 1.0f);
 
   for (const ScaleFactorPair& pair : kScaleFactorPairs)
-    succeed |= AddImageSkiaRep(image,
+    succeed |= AddImageSkiaRep(reps,
                                path.InsertBeforeExtensionASCII(pair.name),
                                pair.scale);
   return succeed;
 }
 
+gfx::ImageSkia CreateImageSkia(const ImageReps& reps) {
+  gfx::ImageSkia image;
+  for (const gfx::ImageSkiaRep& rep : reps)
+    image.AddRepresentation(rep);
+  return image;
+}
+
+ImageReps DecodeImageFromPath(const base::FilePath& path) {
+  ImageReps reps;
+  PopulateImageSkiaRepsFromPath(&reps, path);
+  return reps;
+}
+
+ImageReps DecodeImageFromBuffer(const std::string& data, double scale_factor) {
+  ImageReps reps;
+  AddImageSkiaRep(&reps, reinterpret_cast<const unsigned char*>(data.data()),
+                  data.size(), scale_factor);
+  return reps;
+}
+
+ImageReps DecodeImageFromDataURL(const GURL& url) {
+  ImageReps reps;
+  std::string mime_type, charset, data;
+  if (net::DataURL::Parse(url, &mime_type, &charset, &data) &&
+      (mime_type == "image/png" || mime_type == "image/jpeg")) {
+    AddImageSkiaRep(&reps, reinterpret_cast<const unsigned char*>(data.data()),
+                    data.size(), 1.0f);
+  }
+  return reps;
+}
+
+std::vector<unsigned char> EncodeBitmap(const SkBitmap& bitmap,
+                                        EncodeFormat format,
+                                        int quality) {
+  std::vector<unsigned char> output;
+  bool success = format == ENCODE_JPEG ?
+      gfx::JPEGCodec::Encode(bitmap, quality, &output) :
+      gfx::PNGCodec::EncodeBGRASkBitmap(bitmap, false, &output);
+  if (!success)
+    output.clear();
+  return output;
+}
+
+std::vector<std::vector<unsigned char>> EncodeBitmaps(
+    const std::vector<SkBitmap>& bitmaps, EncodeFormat format, int quality) {
+  std::vector<std::vector<unsigned char>> outputs;
+  outputs.reserve(bitmaps.size());
+  for (const SkBitmap& bitmap : bitmaps)
+    outputs.push_back(EncodeBitmap(bitmap, format, quality));
+  return outputs;
+}
+
+v8::Local<v8::Value> EncodedDataToV8(v8::Isolate* isolate,
+                                     const std::vector<unsigned char>& data,
+                                     bool data_url) {
+  if (data_url) {
+    std::string url;
+    base::Base64Encode(
+        base::StringPiece(reinterpret_cast<const char*>(data.data()),
+                          data.size()),
+        &url);
+    url.insert(0, "data:image/png;base64,");
+    return mate::StringToV8(isolate, url);
+  }
+  return node::Buffer::Copy(isolate,
+                            reinterpret_cast<const char*>(data.data()),
+                            data.size()).ToLocalChecked();
+}
+
+void OnImageEncoded(v8::Isolate* isolate,
+                    bool data_url,
+                    const EncodeCallback& callback,
+                    std::vector<unsigned char> output) {
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(EncodedDataToV8(isolate, output, data_url));
+}
+
+void OnImagesEncoded(v8::Isolate* isolate,
+                     const EncodeCallback& callback,
+                     std::vector<std::vector<unsigned char>> outputs) {
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  v8::Local<v8::Array> buffers =
+      v8::Array::New(isolate, static_cast<int>(outputs.size()));
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    buffers->Set(static_cast<uint32_t>(i),
+                 EncodedDataToV8(isolate, outputs[i], false));
+  }
+  callback.Run(buffers);
+}
+
+// Encode the 1x representation of |image| on the task scheduler.
+void EncodeImageAsync(v8::Isolate* isolate,
+                      const gfx::Image& image,
+                      EncodeFormat format,
+                      int quality,
+                      bool data_url,
+                      const EncodeCallback& callback) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::Bind(&EncodeBitmap, image.AsBitmap(), format, quality),
+      base::Bind(&OnImageEncoded, isolate, data_url, callback));
+}
+
+SkBitmap ResizeBitmap(const SkBitmap& bitmap,
+                      skia::ImageOperations::ResizeMethod method,
+                      int width,
+                      int height) {
+  return skia::ImageOperations::Resize(bitmap, method, width, height);
+}
+
+void OnImageResized(v8::Isolate* isolate,
+                    const NativeImage::ImageCallback& callback,
+                    SkBitmap bitmap) {
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  callback.Run(NativeImage::Create(isolate,
+                                   gfx::Image::CreateFrom1xBitmap(bitmap)));
+}
+
 base::FilePath NormalizePath(const base::FilePath& path) {
   if (!path.ReferencesParent()) {
     return path;
@@ -223,7 +358,14 @@ HICON NativeImage::GetHICON(int size) {
 }
 #endif
 
-v8::Local<v8::Value> NativeImage::ToPNG(v8::Isolate* isolate) {
+v8::Local<v8::Value> NativeImage::ToPNG(mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  EncodeCallback callback;
+  if (args->GetNext(&callback)) {
+    EncodeImageAsync(isolate, image_, ENCODE_PNG, 0, false, callback);
+    return v8::Undefined(isolate);
+  }
+
   scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
   return node::Buffer::Copy(isolate,
                             reinterpret_cast<const char*>(png->front()),
@@ -238,7 +380,14 @@ v8::Local<v8::Value> NativeImage::ToBitmap(v8::Isolate* isolate) {
                             bitmap->computeByteSize()).ToLocalChecked();
 }
 
-v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
+v8::Local<v8::Value> NativeImage::ToJPEG(mate::Arguments* args, int quality) {
+  v8::Isolate* isolate = args->isolate();
+  EncodeCallback callback;
+  if (args->GetNext(&callback)) {
+    EncodeImageAsync(isolate, image_, ENCODE_JPEG, quality, false, callback);
+    return v8::Undefined(isolate);
+  }
+
   std::vector<unsigned char> output;
   gfx::JPEG1xEncodedDataFromImage(image_, quality, &output);
   return node::Buffer::Copy(
@@ -247,13 +396,83 @@ v8::Local<v8::Value> NativeImage::ToJPEG(v8::Isolate* isolate, int quality) {
       static_cast<size_t>(output.size())).ToLocalChecked();
 }
 
-std::string NativeImage::ToDataURL() {
+v8::Local<v8::Value> NativeImage::ToDataURL(mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  EncodeCallback callback;
+  if (args->GetNext(&callback)) {
+    EncodeImageAsync(isolate, image_, ENCODE_PNG, 0, true, callback);
+    return v8::Undefined(isolate);
+  }
+
   scoped_refptr<base::RefCountedMemory> png = image_.As1xPNGBytes();
   std::string data_url;
   data_url.insert(data_url.end(), png->front(), png->front() + png->size());
   base::Base64Encode(data_url, &data_url);
   data_url.insert(0, "data:image/png;base64,");
-  return data_url;
+  return mate::StringToV8(isolate, data_url);
+}
+
+v8::Local<v8::Value> NativeImage::Resize(mate::Arguments* args) {
+  v8::Isolate* isolate = args->isolate();
+  mate::Dictionary options;
+  if (!args->GetNext(&options)) {
+    args->ThrowError("Options must be an object");
+    return v8::Undefined(isolate);
+  }
+  ImageCallback callback;
+  args->GetNext(&callback);
+
+  // Keep the aspect ratio when only one of the dimensions is given.
+  gfx::Size size = GetSize();
+  int width = size.width();
+  int height = size.height();
+  bool has_width = options.Get("width", &width);
+  bool has_height = options.Get("height", &height);
+  if (has_width && !has_height && size.width() > 0)
+    height = width * size.height() / size.width();
+  else if (has_height && !has_width && size.height() > 0)
+    width = height * size.width() / size.height();
+
+  skia::ImageOperations::ResizeMethod method =
+      skia::ImageOperations::RESIZE_BEST;
+  std::string quality;
+  if (options.Get("quality", &quality)) {
+    if (quality == "good")
+      method = skia::ImageOperations::RESIZE_GOOD;
+    else if (quality == "better")
+      method = skia::ImageOperations::RESIZE_BETTER;
+  }
+
+  if (IsEmpty() || width <= 0 || height <= 0) {
+    mate::Handle<NativeImage> empty = CreateEmpty(isolate);
+    if (callback.is_null())
+      return empty.ToV8();
+    callback.Run(empty);
+    return v8::Undefined(isolate);
+  }
+
+  if (!callback.is_null()) {
+    base::PostTaskWithTraitsAndReplyWithResult(
+        FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+        base::Bind(&ResizeBitmap, image_.AsBitmap(), method, width, height),
+        base::Bind(&OnImageResized, isolate, callback));
+    return v8::Undefined(isolate);
+  }
+
+  gfx::ImageSkia resized = gfx::ImageSkiaOperations::CreateResizedImage(
+      image_.AsImageSkia(), method, gfx::Size(width, height));
+  return Create(isolate, gfx::Image(resized)).ToV8();
+}
+
+mate::Handle<NativeImage> NativeImage::Crop(v8::Isolate* isolate,
+                                            const gfx::Rect& rect) {
+  gfx::Rect bounds = gfx::IntersectRects(rect, gfx::Rect(GetSize()));
+  if (bounds.IsEmpty())
+    return CreateEmpty(isolate);
+
+  gfx::ImageSkia cropped = gfx::ImageSkiaOperations::ExtractSubset(
+      image_.AsImageSkia(), bounds);
+  return Create(isolate, gfx::Image(cropped));
 }
 
 v8::Local<v8::Value> NativeImage::GetBitmap(v8::Isolate* isolate) {
@@ -334,9 +553,9 @@ mate::Handle<NativeImage> NativeImage::CreateFromPath(
                               new NativeImage(isolate, image_path));
   }
 #endif
-  gfx::ImageSkia image_skia;
-  PopulateImageSkiaRepsFromPath(&image_skia, image_path);
-  gfx::Image image(image_skia);
+  ImageReps reps;
+  PopulateImageSkiaRepsFromPath(&reps, image_path);
+  gfx::Image image(CreateImageSkia(reps));
   mate::Handle<NativeImage> handle = Create(isolate, image);
 #if defined(OS_MACOSX)
   if (IsTemplateFilename(image_path))
@@ -347,16 +566,14 @@ mate::Handle<NativeImage> NativeImage::CreateFromPath(
 
 // static
 mate::Handle<NativeImage> NativeImage::CreateFromBuffer(
-    mate::Arguments* args, v8::Local<v8::Value> buffer) {
-  double scale_factor = 1.;
-  args->GetNext(&scale_factor);
-
-  gfx::ImageSkia image_skia;
-  AddImageSkiaRep(&image_skia,
-                  reinterpret_cast<unsigned char*>(node::Buffer::Data(buffer)),
-                  node::Buffer::Length(buffer),
+    v8::Isolate* isolate, const char* buffer, size_t length,
+    double scale_factor) {
+  ImageReps reps;
+  AddImageSkiaRep(&reps,
+                  reinterpret_cast<const unsigned char*>(buffer),
+                  length,
                   scale_factor);
-  return Create(args->isolate(), gfx::Image(image_skia));
+  return Create(isolate, gfx::Image(CreateImageSkia(reps)));
 }
 
 // static
@@ -373,6 +590,103 @@ mate::Handle<NativeImage> NativeImage::CreateFromDataURL(
   return CreateEmpty(isolate);
 }
 
+// static
+void NativeImage::CreateFromPathAsync(v8::Isolate* isolate,
+                                      const base::FilePath& path,
+                                      const ImageCallback& callback) {
+  base::FilePath image_path = NormalizePath(path);
+#if defined(OS_WIN)
+  // Icons are loaded through HICON, which is not done off the main thread.
+  if (image_path.MatchesExtension(FILE_PATH_LITERAL(".ico"))) {
+    callback.Run(CreateFromPath(isolate, image_path));
+    return;
+  }
+#endif
+  bool is_template = false;
+#if defined(OS_MACOSX)
+  is_template = IsTemplateFilename(image_path);
+#endif
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::MayBlock(), base::TaskPriority::USER_VISIBLE},
+      base::Bind(&DecodeImageFromPath, image_path),
+      base::Bind(&NativeImage::OnImageDecoded, isolate, is_template,
+                 callback));
+}
+
+// static
+void NativeImage::CreateFromBufferAsync(v8::Isolate* isolate,
+                                        const std::string& data,
+                                        double scale_factor,
+                                        const ImageCallback& callback) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::Bind(&DecodeImageFromBuffer, data, scale_factor),
+      base::Bind(&NativeImage::OnImageDecoded, isolate, false, callback));
+}
+
+// static
+void NativeImage::CreateFromDataURLAsync(v8::Isolate* isolate,
+                                         const GURL& url,
+                                         const ImageCallback& callback) {
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::Bind(&DecodeImageFromDataURL, url),
+      base::Bind(&NativeImage::OnImageDecoded, isolate, false, callback));
+}
+
+// static
+void NativeImage::OnImageDecoded(v8::Isolate* isolate,
+                                 bool is_template,
+                                 const ImageCallback& callback,
+                                 std::vector<gfx::ImageSkiaRep> reps) {
+  mate::Locker locker(isolate);
+  v8::HandleScope handle_scope(isolate);
+  mate::Handle<NativeImage> handle =
+      Create(isolate, gfx::Image(CreateImageSkia(reps)));
+  if (is_template)
+    handle->SetTemplateImage(true);
+  callback.Run(handle);
+}
+
+// static
+void NativeImage::EncodeImages(mate::Arguments* args) {
+  std::vector<mate::Handle<NativeImage>> images;
+  if (!args->GetNext(&images)) {
+    args->ThrowError("Images must be an array of NativeImage");
+    return;
+  }
+
+  EncodeFormat format = ENCODE_PNG;
+  int quality = 90;
+  if (!args->PeekNext().IsEmpty() && !args->PeekNext()->IsFunction()) {
+    mate::Dictionary options;
+    if (!args->GetNext(&options)) {
+      args->ThrowError("Options must be an object");
+      return;
+    }
+    std::string name;
+    if (options.Get("format", &name) && name == "jpeg")
+      format = ENCODE_JPEG;
+    options.Get("quality", &quality);
+  }
+
+  EncodeCallback callback;
+  if (!args->GetNext(&callback)) {
+    args->ThrowError("Callback must be a function");
+    return;
+  }
+
+  std::vector<SkBitmap> bitmaps;
+  bitmaps.reserve(images.size());
+  for (const auto& image : images)
+    bitmaps.push_back(image->image().AsBitmap());
+
+  base::PostTaskWithTraitsAndReplyWithResult(
+      FROM_HERE, {base::TaskPriority::USER_VISIBLE},
+      base::Bind(&EncodeBitmaps, bitmaps, format, quality),
+      base::Bind(&OnImagesEncoded, args->isolate(), callback));
+}
+
 // static
 void NativeImage::BuildPrototype(
     v8::Isolate* isolate, v8::Local<v8::FunctionTemplate> prototype) {
@@ -384,6 +698,8 @@ void NativeImage::BuildPrototype(
       .SetMethod("getBitmap", &NativeImage::GetBitmap)
       .SetMethod("getNativeHandle", &NativeImage::GetNativeHandle)
       .SetMethod("toDataURL", &NativeImage::ToDataURL)
+      .SetMethod("resize", &NativeImage::Resize)
+      .SetMethod("crop", &NativeImage::Crop)
       .SetMethod("isEmpty", &NativeImage::IsEmpty)
       .SetMethod("getSize", &NativeImage::GetSize)
       .SetMethod("setTemplateImage", &NativeImage::SetTemplateImage)
@@ -429,14 +745,67 @@ bool Converter<mate::Handle<atom::api::NativeImage>>::FromV8(
 
 namespace {
 
+using atom::api::NativeImage;
+
+// The creators decode on the task scheduler when a callback is passed.
+v8::Local<v8::Value> CreateFromPath(mate::Arguments* args) {
+  base::FilePath path;
+  if (!args->GetNext(&path)) {
+    args->ThrowError("Path must be a string");
+    return v8::Undefined(args->isolate());
+  }
+  NativeImage::ImageCallback callback;
+  if (args->GetNext(&callback)) {
+    NativeImage::CreateFromPathAsync(args->isolate(), path, callback);
+    return v8::Undefined(args->isolate());
+  }
+  return NativeImage::CreateFromPath(args->isolate(), path).ToV8();
+}
+
+v8::Local<v8::Value> CreateFromBuffer(mate::Arguments* args) {
+  v8::Local<v8::Value> buffer;
+  if (!args->GetNext(&buffer) || !node::Buffer::HasInstance(buffer)) {
+    args->ThrowError("Buffer must be a node Buffer");
+    return v8::Undefined(args->isolate());
+  }
+  double scale_factor = 1.;
+  if (!args->PeekNext().IsEmpty() && !args->PeekNext()->IsFunction())
+    args->GetNext(&scale_factor);
+  NativeImage::ImageCallback callback;
+  if (args->GetNext(&callback)) {
+    // The buffer is copied, JS may reuse it before the decoding is done.
+    std::string data(node::Buffer::Data(buffer), node::Buffer::Length(buffer));
+    NativeImage::CreateFromBufferAsync(args->isolate(), data, scale_factor,
+                                       callback);
+    return v8::Undefined(args->isolate());
+  }
+  return NativeImage::CreateFromBuffer(
+      args->isolate(), node::Buffer::Data(buffer),
+      node::Buffer::Length(buffer), scale_factor).ToV8();
+}
+
+v8::Local<v8::Value> CreateFromDataURL(mate::Arguments* args) {
+  GURL url;
+  if (!args->GetNext(&url)) {
+    args->ThrowError("Data URL must be a string");
+    return v8::Undefined(args->isolate());
+  }
+  NativeImage::ImageCallback callback;
+  if (args->GetNext(&callback)) {
+    NativeImage::CreateFromDataURLAsync(args->isolate(), url, callback);
+    return v8::Undefined(args->isolate());
+  }
+  return NativeImage::CreateFromDataURL(args->isolate(), url).ToV8();
+}
+
 void Initialize(v8::Local<v8::Object> exports, v8::Local<v8::Value> unused,
                 v8::Local<v8::Context> context, void* priv) {
   mate::Dictionary dict(context->GetIsolate(), exports);
-  dict.SetMethod("createEmpty", &atom::api::NativeImage::CreateEmpty);
-  dict.SetMethod("createFromPath", &atom::api::NativeImage::CreateFromPath);
-  dict.SetMethod("createFromBuffer", &atom::api::NativeImage::CreateFromBuffer);
-  dict.SetMethod("createFromDataURL",
-                 &atom::api::NativeImage::CreateFromDataURL);
+  dict.SetMethod("createEmpty", &NativeImage::CreateEmpty);
+  dict.SetMethod("createFromPath", &CreateFromPath);
+  dict.SetMethod("createFromBuffer", &CreateFromBuffer);
+  dict.SetMethod("createFromDataURL", &CreateFromDataURL);
+  dict.SetMethod("encodeImages", &NativeImage::EncodeImages);
 }
 
 }  // namespace
@@ -7,10 +7,13 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
+#include "base/callback.h"
 #include "native_mate/handle.h"
 #include "native_mate/wrappable.h"
 #include "ui/gfx/image/image.h"
+#include "ui/gfx/image/image_skia_rep.h"
 
 #if defined(OS_WIN)
 #include "base/files/file_path.h"
@@ -24,6 +27,7 @@ class FilePath;
 }
 
 namespace gfx {
+class Rect;
 class Size;
 }
 
@@ -37,6 +41,8 @@ namespace api {
 
 class NativeImage : public mate::Wrappable<NativeImage> {
  public:
+  using ImageCallback = base::Callback<void(mate::Handle<NativeImage>)>;
+
   static mate::Handle<NativeImage> CreateEmpty(v8::Isolate* isolate);
   static mate::Handle<NativeImage> Create(
       v8::Isolate* isolate, const gfx::Image& image);
@@ -47,10 +53,28 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   static mate::Handle<NativeImage> CreateFromPath(
       v8::Isolate* isolate, const base::FilePath& path);
   static mate::Handle<NativeImage> CreateFromBuffer(
-      mate::Arguments* args, v8::Local<v8::Value> buffer);
+      v8::Isolate* isolate, const char* buffer, size_t length,
+      double scale_factor);
   static mate::Handle<NativeImage> CreateFromDataURL(
       v8::Isolate* isolate, const GURL& url);
 
+  // Decode the image on the task scheduler and pass it to |callback| on the
+  // calling thread.
+  static void CreateFromPathAsync(v8::Isolate* isolate,
+                                  const base::FilePath& path,
+                                  const ImageCallback& callback);
+  static void CreateFromBufferAsync(v8::Isolate* isolate,
+                                    const std::string& data,
+                                    double scale_factor,
+                                    const ImageCallback& callback);
+  static void CreateFromDataURLAsync(v8::Isolate* isolate,
+                                     const GURL& url,
+                                     const ImageCallback& callback);
+
+  // Encode many images in one task, |args| are the images, the optional
+  // encoding options and the callback.
+  static void EncodeImages(mate::Arguments* args);
+
   static void BuildPrototype(v8::Isolate* isolate,
                              v8::Local<v8::FunctionTemplate> prototype);
 
@@ -68,14 +92,17 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   ~NativeImage() override;
 
  private:
-  v8::Local<v8::Value> ToPNG(v8::Isolate* isolate);
-  v8::Local<v8::Value> ToJPEG(v8::Isolate* isolate, int quality);
+  // The encoders run on the task scheduler when a callback is passed.
+  v8::Local<v8::Value> ToPNG(mate::Arguments* args);
+  v8::Local<v8::Value> ToJPEG(mate::Arguments* args, int quality);
   v8::Local<v8::Value> ToBitmap(v8::Isolate* isolate);
   v8::Local<v8::Value> GetBitmap(v8::Isolate* isolate);
   v8::Local<v8::Value> GetNativeHandle(
     v8::Isolate* isolate,
     mate::Arguments* args);
-  std::string ToDataURL();
+  v8::Local<v8::Value> ToDataURL(mate::Arguments* args);
+  v8::Local<v8::Value> Resize(mate::Arguments* args);
+  mate::Handle<NativeImage> Crop(v8::Isolate* isolate, const gfx::Rect& rect);
   bool IsEmpty();
   gfx::Size GetSize();
 
@@ -84,6 +111,11 @@ class NativeImage : public mate::Wrappable<NativeImage> {
   // Determine if the image is a template image.
   bool IsTemplateImage();
 
+  static void OnImageDecoded(v8::Isolate* isolate,
+                             bool is_template,
+                             const ImageCallback& callback,
+                             std::vector<gfx::ImageSkiaRep> reps);
+
 #if defined(OS_WIN)
   base::FilePath hicon_path_;
   std::map<int, base::win::ScopedHICON> hicons_;
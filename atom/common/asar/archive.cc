@@ -4,6 +4,7 @@
 
 #include "atom/common/asar/archive.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -11,10 +12,12 @@
 #include "atom/common/asar/scoped_temporary_file.h"
 #include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/pickle.h"
 #include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
 #include "base/task_scheduler/post_task.h"
 #include "base/values.h"
 
@@ -34,64 +37,8 @@ const char kSeparators[] = "\\/";
 const char kSeparators[] = "/";
 #endif
 
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out);
-
-// Gets the "files" from "dir".
-bool GetFilesNode(const base::DictionaryValue* root,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  // Test for symbol linked directory.
-  std::string link;
-  if (dir->GetStringWithoutPathExpansion("link", &link)) {
-    const base::DictionaryValue* linked_node = nullptr;
-    if (!GetNodeFromPath(link, root, &linked_node))
-      return false;
-    dir = linked_node;
-  }
-
-  return dir->GetDictionaryWithoutPathExpansion("files", out);
-}
-
-// Gets sub-file "name" from "dir".
-bool GetChildNode(const base::DictionaryValue* root,
-                  const std::string& name,
-                  const base::DictionaryValue* dir,
-                  const base::DictionaryValue** out) {
-  if (name == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* files = nullptr;
-  return GetFilesNode(root, dir, &files) &&
-         files->GetDictionaryWithoutPathExpansion(name, out);
-}
-
-// Gets the node of "path" from "root".
-bool GetNodeFromPath(std::string path,
-                     const base::DictionaryValue* root,
-                     const base::DictionaryValue** out) {
-  if (path == "") {
-    *out = root;
-    return true;
-  }
-
-  const base::DictionaryValue* dir = root;
-  for (size_t delimiter_position = path.find_first_of(kSeparators);
-       delimiter_position != std::string::npos;
-       delimiter_position = path.find_first_of(kSeparators)) {
-    const base::DictionaryValue* child = nullptr;
-    if (!GetChildNode(root, path.substr(0, delimiter_position), dir, &child))
-      return false;
-
-    dir = child;
-    path.erase(0, delimiter_position + 1);
-  }
-
-  return GetChildNode(root, path, dir, out);
-}
+// Links deeper than this are treated as dangling, like ELOOP.
+const int kMaxLinkDepth = 40;
 
 bool FillFileInfoWithNode(Archive::FileInfo* info,
                           uint32_t header_size,
@@ -116,8 +63,23 @@ bool FillFileInfoWithNode(Archive::FileInfo* info,
   return true;
 }
 
+std::string JoinPath(const std::string& dir, const std::string& name) {
+  return dir.empty() ? name : dir + '/' + name;
+}
+
 }  // namespace
 
+const uint32_t Archive::kInvalidEntry = static_cast<uint32_t>(-1);
+
+Archive::Entry::Entry()
+    : type(TYPE_FILE),
+      has_info(false),
+      link_resolved(false),
+      link_target(kInvalidEntry),
+      path(nullptr) {}
+
+Archive::Entry::~Entry() {}
+
 Archive::Archive(const base::FilePath& path)
     : path_(path), file_(base::File::FILE_OK), header_size_(0) {
   base::ThreadRestrictions::ScopedAllowIO allow_io;
@@ -199,80 +161,179 @@ bool Archive::Init() {
   }
 
   header_size_ = 8 + size;
-  header_.reset(static_cast<base::DictionaryValue*>(value.release()));
+
+  // Flatten the header into |entries_| and drop the JSON tree.
+  entries_.clear();
+  index_.clear();
+  AddEntry(std::string(),
+           static_cast<const base::DictionaryValue*>(value.get()));
+  for (uint32_t i = 0; i < entries_.size(); ++i)
+    ResolveLink(i, 0);
   return true;
 }
 
-bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
-  if (!header_)
-    return false;
+bool Archive::MapFile() {
+  if (mapped_file_)
+    return mapped_file_->IsValid();
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  mapped_file_.reset(new base::MemoryMappedFile);
+  base::ThreadRestrictions::ScopedAllowIO allow_io;
+  if (!mapped_file_->Initialize(path_)) {
+    LOG(WARNING) << "Failed to map " << path_.value();
     return false;
+  }
+  return true;
+}
+
+uint32_t Archive::AddEntry(const std::string& path,
+                           const base::DictionaryValue* node) {
+  uint32_t index = static_cast<uint32_t>(entries_.size());
+  entries_.emplace_back();
+  entries_[index].path = &index_.emplace(path, index).first->first;
 
+  // |entries_| may reallocate while adding children, so don't hold references
+  // to the entry across the recursion.
   std::string link;
-  if (node->GetString("link", &link))
-    return GetFileInfo(base::FilePath::FromUTF8Unsafe(link), info);
+  const base::DictionaryValue* files = nullptr;
+  if (node->GetStringWithoutPathExpansion("link", &link)) {
+    entries_[index].type = Entry::TYPE_LINK;
+    entries_[index].link = link;
+  } else if (node->GetDictionaryWithoutPathExpansion("files", &files)) {
+    entries_[index].type = Entry::TYPE_DIRECTORY;
+    std::vector<uint32_t> children;
+    for (base::DictionaryValue::Iterator iter(*files); !iter.IsAtEnd();
+         iter.Advance()) {
+      const base::DictionaryValue* child = nullptr;
+      if (iter.value().GetAsDictionary(&child))
+        children.push_back(AddEntry(JoinPath(path, iter.key()), child));
+    }
+    entries_[index].children.swap(children);
+  } else {
+    entries_[index].has_info =
+        FillFileInfoWithNode(&entries_[index].info, header_size_, node);
+  }
+  return index;
+}
 
-  return FillFileInfoWithNode(info, header_size_, node);
+uint32_t Archive::ResolveLink(uint32_t index, int depth) {
+  if (entries_[index].type != Entry::TYPE_LINK)
+    return index;
+  if (entries_[index].link_resolved)
+    return entries_[index].link_target;
+  if (depth > kMaxLinkDepth)
+    return kInvalidEntry;
+
+  uint32_t target = FindEntry(entries_[index].link, depth + 1);
+  if (target != kInvalidEntry)
+    target = ResolveLink(target, depth + 1);
+  entries_[index].link_target = target;
+  entries_[index].link_resolved = true;
+  return target;
 }
 
-bool Archive::Stat(const base::FilePath& path, Stats* stats) {
-  if (!header_)
+uint32_t Archive::FindEntry(const base::FilePath& path) {
+  std::string key = path.AsUTF8Unsafe();
+#if defined(OS_WIN)
+  std::replace(key.begin(), key.end(), '\\', '/');
+#endif
+  return FindEntry(key, 0);
+}
+
+uint32_t Archive::FindEntry(const std::string& path, int depth) {
+  if (entries_.empty())
+    return kInvalidEntry;
+
+  auto it = index_.find(path);
+  if (it != index_.end())
+    return it->second;
+
+  // Slow path for paths that go through linked directories or contain empty
+  // components, walk them one component at a time.
+  uint32_t current = 0;
+  for (const std::string& name : base::SplitString(
+           path, kSeparators, base::KEEP_WHITESPACE, base::SPLIT_WANT_ALL)) {
+    if (name.empty()) {
+      current = 0;
+      continue;
+    }
+
+    uint32_t dir = ResolveLink(current, depth);
+    if (dir == kInvalidEntry ||
+        entries_[dir].type != Entry::TYPE_DIRECTORY)
+      return kInvalidEntry;
+
+    it = index_.find(JoinPath(*entries_[dir].path, name));
+    if (it == index_.end())
+      return kInvalidEntry;
+    current = it->second;
+  }
+  return current;
+}
+
+bool Archive::GetFileInfo(const base::FilePath& path, FileInfo* info) {
+  uint32_t index = FindEntry(path);
+  if (index == kInvalidEntry)
+    return false;
+
+  index = ResolveLink(index, 0);
+  if (index == kInvalidEntry || !entries_[index].has_info)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  *info = entries_[index].info;
+  return true;
+}
+
+bool Archive::Stat(const base::FilePath& path, Stats* stats) {
+  uint32_t index = FindEntry(path);
+  if (index == kInvalidEntry)
     return false;
 
-  if (node->HasKey("link")) {
+  const Entry& entry = entries_[index];
+  if (entry.type == Entry::TYPE_LINK) {
     stats->is_file = false;
     stats->is_link = true;
     return true;
   }
 
-  if (node->HasKey("files")) {
+  if (entry.type == Entry::TYPE_DIRECTORY) {
     stats->is_file = false;
     stats->is_directory = true;
     return true;
   }
 
-  return FillFileInfoWithNode(stats, header_size_, node);
+  if (!entry.has_info)
+    return false;
+
+  static_cast<FileInfo&>(*stats) = entry.info;
+  return true;
 }
 
 bool Archive::Readdir(const base::FilePath& path,
                       std::vector<base::FilePath>* list) {
-  if (!header_)
-    return false;
-
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
+  uint32_t index = FindEntry(path);
+  if (index == kInvalidEntry)
     return false;
 
-  const base::DictionaryValue* files;
-  if (!GetFilesNode(header_.get(), node, &files))
+  index = ResolveLink(index, 0);
+  if (index == kInvalidEntry ||
+      entries_[index].type != Entry::TYPE_DIRECTORY)
     return false;
 
-  base::DictionaryValue::Iterator iter(*files);
-  while (!iter.IsAtEnd()) {
-    list->push_back(base::FilePath::FromUTF8Unsafe(iter.key()));
-    iter.Advance();
+  for (uint32_t child : entries_[index].children) {
+    const std::string& child_path = *entries_[child].path;
+    list->push_back(base::FilePath::FromUTF8Unsafe(
+        child_path.substr(child_path.find_last_of('/') + 1)));
   }
   return true;
 }
 
 bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
-  if (!header_)
+  uint32_t index = FindEntry(path);
+  if (index == kInvalidEntry)
     return false;
 
-  const base::DictionaryValue* node;
-  if (!GetNodeFromPath(path.AsUTF8Unsafe(), header_.get(), &node))
-    return false;
-
-  std::string link;
-  if (node->GetString("link", &link)) {
-    *realpath = base::FilePath::FromUTF8Unsafe(link);
+  if (entries_[index].type == Entry::TYPE_LINK) {
+    *realpath = base::FilePath::FromUTF8Unsafe(entries_[index].link);
     return true;
   }
 
@@ -280,7 +341,26 @@ bool Archive::Realpath(const base::FilePath& path, base::FilePath* realpath) {
   return true;
 }
 
+bool Archive::GetFileContents(const base::FilePath& path,
+                              base::StringPiece* contents) {
+  if (!mapped_file_ || !mapped_file_->IsValid())
+    return false;
+
+  FileInfo info;
+  if (!GetFileInfo(path, &info) || info.unpacked)
+    return false;
+
+  if (info.offset + info.size > mapped_file_->length())
+    return false;
+
+  *contents = base::StringPiece(
+      reinterpret_cast<const char*>(mapped_file_->data()) + info.offset,
+      info.size);
+  return true;
+}
+
 bool Archive::CopyFileOut(const base::FilePath& path, base::FilePath* out) {
+  base::AutoLock auto_lock(external_files_lock_);
   auto it = external_files_.find(path.value());
   if (it != external_files_.end()) {
     *out = it->second->path();
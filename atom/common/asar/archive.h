@@ -6,14 +6,18 @@
 #define ATOM_COMMON_ASAR_ARCHIVE_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "base/files/file.h"
 #include "base/files/file_path.h"
+#include "base/strings/string_piece.h"
+#include "base/synchronization/lock.h"
 
 namespace base {
 class DictionaryValue;
+class MemoryMappedFile;
 }
 
 namespace asar {
@@ -21,7 +25,7 @@ namespace asar {
 class ScopedTemporaryFile;
 
 // This class represents an asar package, and provides methods to read
-// information from it.
+// information from it. Once initialized it is safe to use from any thread.
 class Archive {
  public:
   struct FileInfo {
@@ -45,6 +49,10 @@ class Archive {
   // Read and parse the header.
   bool Init();
 
+  // Map the whole archive into memory so file contents can be accessed with
+  // GetFileContents().
+  bool MapFile();
+
   // Get the info of a file.
   bool GetFileInfo(const base::FilePath& path, FileInfo* info);
 
@@ -57,6 +65,11 @@ class Archive {
   // Fs.realpath(path).
   bool Realpath(const base::FilePath& path, base::FilePath* realpath);
 
+  // Get a view of a packed file's contents in the mapped archive, the view is
+  // valid as long as the archive is alive. Fails for unpacked files or when
+  // the archive is not mapped.
+  bool GetFileContents(const base::FilePath& path, base::StringPiece* contents);
+
   // Copy the file into a temporary file, and return the new path.
   // For unpacked file, this method will return its real path.
   bool CopyFileOut(const base::FilePath& path, base::FilePath* out);
@@ -65,16 +78,59 @@ class Archive {
   int GetFD() const;
 
   base::FilePath path() const { return path_; }
-  base::DictionaryValue* header() const { return header_.get(); }
 
  private:
+  // A node of the header, flattened into |entries_| when the archive is
+  // opened so lookups don't have to walk the JSON tree.
+  struct Entry {
+    enum Type : uint8_t { TYPE_FILE, TYPE_DIRECTORY, TYPE_LINK };
+
+    Entry();
+    ~Entry();
+
+    Type type;
+    // Whether size and offset were parsed successfully, only for files.
+    bool has_info;
+    bool link_resolved;
+    FileInfo info;
+    // Index of the final non-link entry this link points to, or
+    // kInvalidEntry if it is dangling.
+    uint32_t link_target;
+    // The raw "link" value, as returned by Realpath().
+    std::string link;
+    // Children of a directory, in the header's (sorted) order.
+    std::vector<uint32_t> children;
+    // Full relative path, owned by the key of |index_|.
+    const std::string* path;
+  };
+
+  static const uint32_t kInvalidEntry;
+
+  // Flattens |node| and its children, returns the index of the new entry.
+  uint32_t AddEntry(const std::string& path,
+                    const base::DictionaryValue* node);
+
+  // Resolves the link chain starting at |index|, only mutates the entries
+  // while the index is built in Init().
+  uint32_t ResolveLink(uint32_t index, int depth);
+
+  // Finds the entry of |path| without following a link at the last
+  // component, returns kInvalidEntry if it doesn't exist.
+  uint32_t FindEntry(const base::FilePath& path);
+  uint32_t FindEntry(const std::string& path, int depth);
+
   base::FilePath path_;
   base::File file_;
   int fd_;
   uint32_t header_size_;
-  std::unique_ptr<base::DictionaryValue> header_;
+  std::unique_ptr<base::MemoryMappedFile> mapped_file_;
+
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, uint32_t> index_;
 
-  // Cached external temporary files.
+  // Cached external temporary files, guarded by |external_files_lock_| since
+  // shared archives are used from several threads.
+  base::Lock external_files_lock_;
   std::unordered_map
     <base::FilePath::StringType, std::unique_ptr<ScopedTemporaryFile>>
       external_files_;
@@ -4,6 +4,7 @@
 
 #include "atom/common/asar/asar_util.h"
 
+#include <functional>
 #include <map>
 #include <string>
 
@@ -11,30 +12,78 @@
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/lazy_instance.h"
-#include "base/stl_util.h"
+#include "base/synchronization/lock.h"
 
 namespace asar {
 
 namespace {
 
-// The global instance of ArchiveMap, will be destroyed on exit.
 typedef std::map<base::FilePath, std::shared_ptr<Archive>> ArchiveMap;
-static base::LazyInstance<ArchiveMap>::DestructorAtExit g_archive_map =
-    LAZY_INSTANCE_INITIALIZER;
+
+// Archives are looked up from the UI, IO and worker threads, so the map is
+// split into shards with their own lock to keep contention low.
+const size_t kArchiveMapShards = 8;
+
+struct ArchiveMapShard {
+  ArchiveMapShard() : hits(0), misses(0) {}
+
+  base::Lock lock;
+  ArchiveMap archives;
+  uint64_t hits;
+  uint64_t misses;
+};
+
+struct ArchiveRegistry {
+  ArchiveMapShard& GetShard(const base::FilePath& path) {
+    size_t hash = std::hash<base::FilePath::StringType>()(path.value());
+    return shards[hash % kArchiveMapShards];
+  }
+
+  ArchiveMapShard shards[kArchiveMapShards];
+};
+
+// The global instance of ArchiveRegistry, will be destroyed on exit.
+static base::LazyInstance<ArchiveRegistry>::DestructorAtExit
+    g_archive_registry = LAZY_INSTANCE_INITIALIZER;
 
 const base::FilePath::CharType kAsarExtension[] = FILE_PATH_LITERAL(".asar");
 
 }  // namespace
 
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path) {
-  ArchiveMap& archive_map = *g_archive_map.Pointer();
-  if (!ContainsKey(archive_map, path)) {
-    std::shared_ptr<Archive> archive(new Archive(path));
-    if (!archive->Init())
-      return nullptr;
-    archive_map[path] = archive;
+  ArchiveMapShard& shard = g_archive_registry.Get().GetShard(path);
+  {
+    base::AutoLock auto_lock(shard.lock);
+    auto it = shard.archives.find(path);
+    if (it != shard.archives.end()) {
+      ++shard.hits;
+      return it->second;
+    }
+    ++shard.misses;
+  }
+
+  // Open the archive without holding the lock, if another thread wins the
+  // race its archive is used instead.
+  std::shared_ptr<Archive> archive(new Archive(path));
+  if (!archive->Init())
+    return nullptr;
+  // Shared archives are mapped so file contents can be served without a
+  // read per file, GetFileContents() falls back to reads if this fails.
+  archive->MapFile();
+
+  base::AutoLock auto_lock(shard.lock);
+  return shard.archives.emplace(path, archive).first->second;
+}
+
+ArchiveRegistryStats GetArchiveRegistryStats() {
+  ArchiveRegistryStats stats;
+  for (ArchiveMapShard& shard : g_archive_registry.Get().shards) {
+    base::AutoLock auto_lock(shard.lock);
+    stats.hits += shard.hits;
+    stats.misses += shard.misses;
+    stats.open_archives += shard.archives.size();
   }
-  return archive_map[path];
+  return stats;
 }
 
 bool GetAsarArchivePath(const base::FilePath& full_path,
@@ -79,6 +128,12 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
     return base::ReadFileToString(real_path, contents);
   }
 
+  base::StringPiece mapped_contents;
+  if (archive->GetFileContents(relative_path, &mapped_contents)) {
+    mapped_contents.CopyToString(contents);
+    return true;
+  }
+
   base::File src(asar_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
   if (!src.IsValid())
     return false;
@@ -88,4 +143,19 @@ bool ReadFileToString(const base::FilePath& path, std::string* contents) {
       info.offset, const_cast<char*>(contents->data()), contents->size());
 }
 
+bool GetFileContents(const base::FilePath& path,
+                     std::shared_ptr<Archive>* archive,
+                     base::StringPiece* contents) {
+  base::FilePath asar_path, relative_path;
+  if (!GetAsarArchivePath(path, &asar_path, &relative_path))
+    return false;
+
+  std::shared_ptr<Archive> result = GetOrCreateAsarArchive(asar_path);
+  if (!result || !result->GetFileContents(relative_path, contents))
+    return false;
+
+  *archive = result;
+  return true;
+}
+
 }  // namespace asar
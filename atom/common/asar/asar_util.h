@@ -5,9 +5,14 @@
 #ifndef ATOM_COMMON_ASAR_ASAR_UTIL_H_
 #define ATOM_COMMON_ASAR_ASAR_UTIL_H_
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include <memory>
 #include <string>
 
+#include "base/strings/string_piece.h"
+
 namespace base {
 class FilePath;
 }
@@ -16,9 +21,19 @@ namespace asar {
 
 class Archive;
 
-// Gets or creates a new Archive from the path.
+struct ArchiveRegistryStats {
+  ArchiveRegistryStats() : hits(0), misses(0), open_archives(0) {}
+  uint64_t hits;
+  uint64_t misses;
+  size_t open_archives;
+};
+
+// Gets or creates a new Archive from the path, can be called from any thread.
 std::shared_ptr<Archive> GetOrCreateAsarArchive(const base::FilePath& path);
 
+// Gets the lookup counters of the Archive registry.
+ArchiveRegistryStats GetArchiveRegistryStats();
+
 // Separates the path to Archive out.
 bool GetAsarArchivePath(const base::FilePath& full_path,
                         base::FilePath* asar_path,
@@ -27,6 +42,13 @@ bool GetAsarArchivePath(const base::FilePath& full_path,
 // Same with base::ReadFileToString but supports asar Archive.
 bool ReadFileToString(const base::FilePath& path, std::string* contents);
 
+// Gets a view of a packed file inside a mapped asar Archive without copying,
+// |archive| keeps the view alive. Returns false for paths outside of an
+// archive and for unpacked files, use ReadFileToString for those.
+bool GetFileContents(const base::FilePath& path,
+                     std::shared_ptr<Archive>* archive,
+                     base::StringPiece* contents);
+
 }  // namespace asar
 
 #endif  // ATOM_COMMON_ASAR_ASAR_UTIL_H_
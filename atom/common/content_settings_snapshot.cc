@@ -0,0 +1,365 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/common/content_settings_snapshot.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+#include "base/logging.h"
+#include "base/values.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
+
+namespace atom {
+
+namespace {
+
+const uint32_t kSnapshotMagic = 0x43535331;  // CSS1
+const char kFirstPartyPattern[] = "[firstParty]";
+
+struct RuleModel {
+  std::string primary_pattern;
+  std::string secondary_pattern;
+  ContentSetting setting;
+  bool first_party;
+};
+
+struct ContentTypeModel {
+  std::string name;
+  std::vector<RuleModel> rules;
+  // Sorted, which is what lookups in the snapshot rely on.
+  std::map<std::string, std::vector<uint32_t>> rules_by_host;
+  std::vector<uint32_t> hostless_rules;
+};
+
+void BuildContentTypeModel(const std::string& name,
+                           const base::ListValue& list,
+                           ContentTypeModel* model) {
+  model->name = name;
+  for (const auto& item : list) {
+    const base::DictionaryValue* dict = nullptr;
+    std::string primary;
+    std::string setting;
+    // skip invalid entries
+    if (!item.GetAsDictionary(&dict) ||
+        !dict->GetString("primaryPattern", &primary) ||
+        !dict->GetString("setting", &setting))
+      continue;
+
+    ContentSettingsPattern primary_pattern =
+        ContentSettingsPattern::FromString(primary);
+    if (!primary_pattern.IsValid())
+      continue;
+
+    RuleModel rule;
+    rule.primary_pattern = primary;
+    dict->GetString("secondaryPattern", &rule.secondary_pattern);
+    rule.first_party = rule.secondary_pattern == kFirstPartyPattern;
+    if (rule.first_party)
+      rule.secondary_pattern.clear();
+    rule.setting = (setting != "block" && setting != "deny")
+        ? CONTENT_SETTING_ALLOW
+        : CONTENT_SETTING_BLOCK;
+
+    uint32_t index = static_cast<uint32_t>(model->rules.size());
+    const std::string& host = primary_pattern.GetHost();
+    if (host.empty())
+      model->hostless_rules.push_back(index);
+    else
+      model->rules_by_host[host].push_back(index);
+    model->rules.push_back(rule);
+  }
+}
+
+template<typename T>
+void WriteAt(std::string* blob, size_t offset, const T& value) {
+  memcpy(&(*blob)[offset], &value, sizeof(T));
+}
+
+}  // namespace
+
+struct ContentSettingsSnapshot::Header {
+  uint32_t magic;
+  uint32_t content_type_count;
+};
+
+struct ContentSettingsSnapshot::ContentType {
+  uint32_t name_offset;
+  uint32_t name_length;
+  uint32_t rule_count;
+  uint32_t rules_offset;
+  uint32_t host_count;
+  uint32_t hosts_offset;
+  uint32_t hostless_count;
+  uint32_t hostless_offset;
+};
+
+struct ContentSettingsSnapshot::Host {
+  uint32_t name_offset;
+  uint32_t name_length;
+  uint32_t rule_count;
+  uint32_t rules_offset;
+};
+
+// static
+std::string ContentSettingsSnapshot::Serialize(
+    const base::DictionaryValue& content_settings) {
+  std::vector<ContentTypeModel> models;
+  for (base::DictionaryValue::Iterator it(content_settings);
+       !it.IsAtEnd();
+       it.Advance()) {
+    const base::ListValue* list = nullptr;
+    if (!it.value().GetAsList(&list))
+      continue;
+    models.push_back(ContentTypeModel());
+    BuildContentTypeModel(it.key(), *list, &models.back());
+  }
+
+  // Lay out the fixed size tables first, the strings go at the end.
+  std::vector<ContentType> content_types(models.size());
+  std::vector<std::vector<Host>> hosts(models.size());
+  size_t offset = sizeof(Header) + models.size() * sizeof(ContentType);
+  for (size_t i = 0; i < models.size(); ++i) {
+    const ContentTypeModel& model = models[i];
+    ContentType& content_type = content_types[i];
+    content_type.rule_count = static_cast<uint32_t>(model.rules.size());
+    content_type.rules_offset = static_cast<uint32_t>(offset);
+    offset += model.rules.size() * sizeof(Rule);
+    content_type.host_count = static_cast<uint32_t>(model.rules_by_host.size());
+    content_type.hosts_offset = static_cast<uint32_t>(offset);
+    offset += model.rules_by_host.size() * sizeof(Host);
+    for (const auto& host_rules : model.rules_by_host) {
+      Host host;
+      host.rule_count = static_cast<uint32_t>(host_rules.second.size());
+      host.rules_offset = static_cast<uint32_t>(offset);
+      offset += host_rules.second.size() * sizeof(uint32_t);
+      hosts[i].push_back(host);
+    }
+    content_type.hostless_count =
+        static_cast<uint32_t>(model.hostless_rules.size());
+    content_type.hostless_offset = static_cast<uint32_t>(offset);
+    offset += model.hostless_rules.size() * sizeof(uint32_t);
+  }
+
+  const size_t strings_offset = offset;
+  std::string strings;
+  auto add_string = [&strings, strings_offset](const std::string& value) {
+    uint32_t string_offset =
+        static_cast<uint32_t>(strings_offset + strings.size());
+    strings.append(value);
+    return string_offset;
+  };
+
+  std::string blob(strings_offset, '\0');
+  Header header;
+  header.magic = kSnapshotMagic;
+  header.content_type_count = static_cast<uint32_t>(models.size());
+  WriteAt(&blob, 0, header);
+
+  for (size_t i = 0; i < models.size(); ++i) {
+    const ContentTypeModel& model = models[i];
+    ContentType& content_type = content_types[i];
+    content_type.name_offset = add_string(model.name);
+    content_type.name_length = static_cast<uint32_t>(model.name.size());
+    WriteAt(&blob, sizeof(Header) + i * sizeof(ContentType), content_type);
+
+    for (size_t j = 0; j < model.rules.size(); ++j) {
+      const RuleModel& rule_model = model.rules[j];
+      Rule rule;
+      rule.primary_pattern_offset = add_string(rule_model.primary_pattern);
+      rule.primary_pattern_length =
+          static_cast<uint32_t>(rule_model.primary_pattern.size());
+      rule.secondary_pattern_offset = add_string(rule_model.secondary_pattern);
+      rule.secondary_pattern_length =
+          static_cast<uint32_t>(rule_model.secondary_pattern.size());
+      rule.setting = rule_model.setting;
+      rule.first_party = rule_model.first_party;
+      WriteAt(&blob, content_type.rules_offset + j * sizeof(Rule), rule);
+    }
+
+    size_t host_index = 0;
+    for (const auto& host_rules : model.rules_by_host) {
+      Host& host = hosts[i][host_index];
+      host.name_offset = add_string(host_rules.first);
+      host.name_length = static_cast<uint32_t>(host_rules.first.size());
+      WriteAt(&blob, content_type.hosts_offset + host_index * sizeof(Host),
+              host);
+      for (size_t j = 0; j < host_rules.second.size(); ++j) {
+        WriteAt(&blob, host.rules_offset + j * sizeof(uint32_t),
+                host_rules.second[j]);
+      }
+      ++host_index;
+    }
+
+    for (size_t j = 0; j < model.hostless_rules.size(); ++j) {
+      WriteAt(&blob, content_type.hostless_offset + j * sizeof(uint32_t),
+              model.hostless_rules[j]);
+    }
+  }
+
+  blob.append(strings);
+  return blob;
+}
+
+ContentSettingsSnapshot::ContentSettingsSnapshot(const void* data,
+                                                 size_t size)
+    : data_(static_cast<const uint8_t*>(data)),
+      size_(size) {
+}
+
+ContentSettingsSnapshot::~ContentSettingsSnapshot() {
+}
+
+bool ContentSettingsSnapshot::IsRangeValid(uint32_t offset,
+                                           uint32_t count,
+                                           size_t item_size) const {
+  if (item_size > 1 && offset % sizeof(uint32_t) != 0)
+    return false;
+  uint64_t end = static_cast<uint64_t>(offset) +
+                 static_cast<uint64_t>(count) * item_size;
+  return end <= size_;
+}
+
+bool ContentSettingsSnapshot::IsValid() const {
+  if (!data_ || size_ < sizeof(Header) || header()->magic != kSnapshotMagic)
+    return false;
+
+  uint32_t content_type_count = header()->content_type_count;
+  if (!IsRangeValid(sizeof(Header), content_type_count, sizeof(ContentType)))
+    return false;
+
+  for (uint32_t i = 0; i < content_type_count; ++i) {
+    const ContentType* type = content_type(i);
+    if (!IsRangeValid(type->name_offset, type->name_length, 1) ||
+        !IsRangeValid(type->rules_offset, type->rule_count, sizeof(Rule)) ||
+        !IsRangeValid(type->hosts_offset, type->host_count, sizeof(Host)) ||
+        !IsRangeValid(type->hostless_offset, type->hostless_count,
+                      sizeof(uint32_t)))
+      return false;
+
+    for (uint32_t j = 0; j < type->rule_count; ++j) {
+      const Rule& rule = GetRule(i, j);
+      if (!IsRangeValid(rule.primary_pattern_offset,
+                        rule.primary_pattern_length, 1) ||
+          !IsRangeValid(rule.secondary_pattern_offset,
+                        rule.secondary_pattern_length, 1))
+        return false;
+    }
+
+    const Host* hosts =
+        reinterpret_cast<const Host*>(data_ + type->hosts_offset);
+    for (uint32_t j = 0; j < type->host_count; ++j) {
+      if (!IsRangeValid(hosts[j].name_offset, hosts[j].name_length, 1) ||
+          !IsRangeValid(hosts[j].rules_offset, hosts[j].rule_count,
+                        sizeof(uint32_t)))
+        return false;
+      const uint32_t* rules = indexes(hosts[j].rules_offset);
+      for (uint32_t k = 0; k < hosts[j].rule_count; ++k) {
+        if (rules[k] >= type->rule_count)
+          return false;
+      }
+    }
+
+    const uint32_t* hostless = indexes(type->hostless_offset);
+    for (uint32_t j = 0; j < type->hostless_count; ++j) {
+      if (hostless[j] >= type->rule_count)
+        return false;
+    }
+  }
+  return true;
+}
+
+std::vector<std::string> ContentSettingsSnapshot::GetContentTypes() const {
+  std::vector<std::string> content_types;
+  for (uint32_t i = 0; i < header()->content_type_count; ++i) {
+    const ContentType* type = content_type(i);
+    content_types.push_back(
+        GetString(type->name_offset, type->name_length).as_string());
+  }
+  return content_types;
+}
+
+int ContentSettingsSnapshot::FindContentType(
+    base::StringPiece content_type_name) const {
+  for (uint32_t i = 0; i < header()->content_type_count; ++i) {
+    const ContentType* type = content_type(i);
+    if (GetString(type->name_offset, type->name_length) == content_type_name)
+      return i;
+  }
+  return -1;
+}
+
+void ContentSettingsSnapshot::GetCandidateRules(
+    int content_type_index,
+    base::StringPiece host,
+    std::vector<uint32_t>* rule_indexes) const {
+  const ContentType* type = content_type(content_type_index);
+  const uint32_t* hostless = indexes(type->hostless_offset);
+  rule_indexes->assign(hostless, hostless + type->hostless_count);
+
+  // Look up the domain suffixes of the host, "a.b.c", "b.c" and "c".
+  const Host* hosts_begin =
+      reinterpret_cast<const Host*>(data_ + type->hosts_offset);
+  const Host* hosts_end = hosts_begin + type->host_count;
+  size_t pos = 0;
+  while (pos != base::StringPiece::npos) {
+    base::StringPiece suffix = host.substr(pos);
+    const Host* it = std::lower_bound(hosts_begin, hosts_end, suffix,
+        [this](const Host& entry, base::StringPiece value) {
+          return GetString(entry.name_offset, entry.name_length) < value;
+        });
+    if (it != hosts_end &&
+        GetString(it->name_offset, it->name_length) == suffix) {
+      const uint32_t* rules = indexes(it->rules_offset);
+      rule_indexes->insert(rule_indexes->end(), rules, rules + it->rule_count);
+    }
+    pos = host.find('.', pos);
+    if (pos != base::StringPiece::npos)
+      ++pos;
+  }
+
+  std::sort(rule_indexes->begin(), rule_indexes->end(),
+            std::greater<uint32_t>());
+  rule_indexes->erase(
+      std::unique(rule_indexes->begin(), rule_indexes->end()),
+      rule_indexes->end());
+}
+
+uint32_t ContentSettingsSnapshot::GetRuleCount(int content_type_index) const {
+  return content_type(content_type_index)->rule_count;
+}
+
+const ContentSettingsSnapshot::Rule& ContentSettingsSnapshot::GetRule(
+    int content_type_index,
+    uint32_t rule_index) const {
+  const ContentType* type = content_type(content_type_index);
+  DCHECK_LT(rule_index, type->rule_count);
+  return reinterpret_cast<const Rule*>(data_ + type->rules_offset)[rule_index];
+}
+
+base::StringPiece ContentSettingsSnapshot::GetString(uint32_t offset,
+                                                     uint32_t length) const {
+  return base::StringPiece(reinterpret_cast<const char*>(data_ + offset),
+                           length);
+}
+
+const ContentSettingsSnapshot::Header* ContentSettingsSnapshot::header() const {
+  return reinterpret_cast<const Header*>(data_);
+}
+
+const ContentSettingsSnapshot::ContentType*
+ContentSettingsSnapshot::content_type(int index) const {
+  return reinterpret_cast<const ContentType*>(
+      data_ + sizeof(Header) + index * sizeof(ContentType));
+}
+
+const uint32_t* ContentSettingsSnapshot::indexes(uint32_t offset) const {
+  return reinterpret_cast<const uint32_t*>(data_ + offset);
+}
+
+}  // namespace atom
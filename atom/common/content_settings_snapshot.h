@@ -0,0 +1,88 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_COMMON_CONTENT_SETTINGS_SNAPSHOT_H_
+#define ATOM_COMMON_CONTENT_SETTINGS_SNAPSHOT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace atom {
+
+// A flat encoding of the content settings rules. The browser builds it once
+// per change and shares it read-only with every renderer, which queries it
+// in place instead of keeping its own copy of the rules.
+//
+// Per content type the rules are kept in precedence order and indexed by the
+// host of their primary pattern. All offsets are relative to the start of
+// the snapshot and all integers are in host byte order.
+class ContentSettingsSnapshot {
+ public:
+  struct Rule {
+    uint32_t primary_pattern_offset;
+    uint32_t primary_pattern_length;
+    uint32_t secondary_pattern_offset;
+    uint32_t secondary_pattern_length;
+    uint32_t setting;
+    // The secondary pattern is [firstParty].
+    uint32_t first_party;
+  };
+
+  // Encodes |content_settings|, a dictionary of content type to a list of
+  // { primaryPattern, secondaryPattern, setting }. Invalid rules are skipped.
+  static std::string Serialize(const base::DictionaryValue& content_settings);
+
+  // |data| is not owned and has to outlive the snapshot.
+  ContentSettingsSnapshot(const void* data, size_t size);
+  ~ContentSettingsSnapshot();
+
+  // Bounds checks the whole snapshot, nothing else may be called if this
+  // returns false.
+  bool IsValid() const;
+
+  std::vector<std::string> GetContentTypes() const;
+
+  // Returns -1 if there are no rules for |content_type|.
+  int FindContentType(base::StringPiece content_type) const;
+
+  // Indexes of the rules of |content_type| that may match a primary url with
+  // |host|, highest precedence first.
+  void GetCandidateRules(int content_type,
+                         base::StringPiece host,
+                         std::vector<uint32_t>* rule_indexes) const;
+
+  // Rules are in precedence order, the last one takes precedence.
+  uint32_t GetRuleCount(int content_type) const;
+  const Rule& GetRule(int content_type, uint32_t rule_index) const;
+  base::StringPiece GetString(uint32_t offset, uint32_t length) const;
+
+ private:
+  struct Header;
+  struct ContentType;
+  struct Host;
+
+  const Header* header() const;
+  const ContentType* content_type(int index) const;
+  const uint32_t* indexes(uint32_t offset) const;
+  bool IsRangeValid(uint32_t offset, uint32_t count, size_t item_size) const;
+
+  const uint8_t* data_;
+  size_t size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsSnapshot);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_COMMON_CONTENT_SETTINGS_SNAPSHOT_H_
@@ -17,6 +17,7 @@
 #include "base/environment.h"
 #include "base/files/file_path.h"
 #include "base/message_loop/message_loop.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/path_service.h"
 #include "base/run_loop.h"
 #include "content/public/browser/browser_thread.h"
@@ -128,6 +129,7 @@ NodeBindings::NodeBindings()
     : message_loop_(nullptr),
       uv_loop_(uv_default_loop()),
       embed_closed_(false),
+      use_embed_thread_(true),
       uv_env_(nullptr),
       weak_factory_(this) {
 }
@@ -135,8 +137,8 @@ NodeBindings::NodeBindings()
 NodeBindings::~NodeBindings() {
   // Quit the embed thread.
   embed_closed_ = true;
-  // node never started
-  if (!uv_env_)
+  // node never started, or its events were not polled in the embed thread
+  if (!uv_env_ || !use_embed_thread_)
     return;
   uv_sem_post(&embed_sem_);
   WakeupEmbedThread();
@@ -227,6 +229,11 @@ void NodeBindings::PrepareMessageLoop() {
   // nothing to do.
   uv_async_init(uv_loop_, &dummy_uv_handle_, nullptr);
 
+  if (WatchBackend()) {
+    use_embed_thread_ = false;
+    return;
+  }
+
   // Start worker that will interrupt main loop when having uv events.
   uv_sem_init(&embed_sem_, 0);
   uv_thread_create(&embed_thread_, EmbedThreadRunner, this);
@@ -245,6 +252,18 @@ void NodeBindings::RunMessageLoop() {
 void NodeBindings::UvRunOnce() {
   DCHECK(BrowserThread::CurrentlyOn(BrowserThread::UI));
 
+  if (!wakeup_time_.is_null()) {
+    base::TimeDelta latency = base::TimeTicks::Now() - wakeup_time_;
+    wakeup_time_ = base::TimeTicks();
+    if (use_embed_thread_) {
+      UMA_HISTOGRAM_CUSTOM_COUNTS("Brave.Node.DispatchLatency.EmbedThread",
+                                  latency.InMicroseconds(), 1, 1000000, 50);
+    } else {
+      UMA_HISTOGRAM_CUSTOM_COUNTS("Brave.Node.DispatchLatency.FdWatcher",
+                                  latency.InMicroseconds(), 1, 1000000, 50);
+    }
+  }
+
   node::Environment* env = uv_env();
 
   // Use Locker in browser process.
@@ -264,7 +283,12 @@ void NodeBindings::UvRunOnce() {
     base::RunLoop::QuitCurrentWhenIdleDeprecated();  // Quit from uv.
 
   // Tell the worker thread to continue polling.
-  uv_sem_post(&embed_sem_);
+  if (use_embed_thread_)
+    uv_sem_post(&embed_sem_);
+}
+
+bool NodeBindings::WatchBackend() {
+  return false;
 }
 
 void NodeBindings::WakeupMainThread() {
@@ -279,6 +303,11 @@ void NodeBindings::WakeupEmbedThread() {
   uv_async_send(&dummy_uv_handle_);
 }
 
+void NodeBindings::MarkWakeup() {
+  if (wakeup_time_.is_null())
+    wakeup_time_ = base::TimeTicks::Now();
+}
+
 // static
 void NodeBindings::EmbedThreadRunner(void *arg) {
   NodeBindings* self = static_cast<NodeBindings*>(arg);
@@ -299,6 +328,7 @@ void NodeBindings::EmbedThreadRunner(void *arg) {
       break;
 
     // Deal with event in main thread.
+    self->MarkWakeup();
     self->WakeupMainThread();
   }
 }
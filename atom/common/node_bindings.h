@@ -7,6 +7,7 @@
 
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
 #include "v8/include/v8.h"
 #include "vendor/node/deps/uv/include/uv.h"
 
@@ -51,6 +52,10 @@ class NodeBindings {
   // Called to poll events in new thread.
   virtual void PollEvents() = 0;
 
+  // Called to integrate libuv's backend with the main thread's message pump,
+  // returns false when the events have to be polled in the embed thread.
+  virtual bool WatchBackend();
+
   // Run the libuv loop for once.
   void UvRunOnce();
 
@@ -60,6 +65,10 @@ class NodeBindings {
   // Interrupt the PollEvents.
   void WakeupEmbedThread();
 
+  // Called when libuv has events to deal with, the time until UvRunOnce
+  // dispatches them is recorded.
+  void MarkWakeup();
+
   // Main thread's MessageLoop.
   base::MessageLoop* message_loop_;
 
@@ -73,6 +82,12 @@ class NodeBindings {
   // Whether the libuv loop has ended.
   bool embed_closed_;
 
+  // Whether events are polled in |embed_thread_|.
+  bool use_embed_thread_;
+
+  // When libuv last had events to deal with, null once they are dispatched.
+  base::TimeTicks wakeup_time_;
+
   // Dummy handle to make uv's loop not quit.
   uv_async_t dummy_uv_handle_;
 
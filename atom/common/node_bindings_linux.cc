@@ -6,11 +6,57 @@
 
 #include <sys/epoll.h>
 
+#if defined(USE_GLIB)
+#include <glib.h>
+#endif
+
+#include "atom/common/options_switches.h"
+#include "base/command_line.h"
+
 namespace atom {
 
+#if defined(USE_GLIB)
+namespace {
+
+struct UvSource {
+  GSource source;
+  GPollFD poll_fd;
+  NodeBindingsLinux* bindings;
+};
+
+gboolean UvSourcePrepare(GSource* source, gint* timeout_ms) {
+  *timeout_ms = static_cast<UvSource*>(source)->bindings->HandlePrepare();
+  return *timeout_ms == 0;
+}
+
+gboolean UvSourceCheck(GSource* source) {
+  UvSource* uv_source = static_cast<UvSource*>(source);
+  return uv_source->bindings->HandleCheck(
+      (uv_source->poll_fd.revents & G_IO_IN) != 0);
+}
+
+gboolean UvSourceDispatch(GSource* source,
+                          GSourceFunc unused_func,
+                          gpointer unused_data) {
+  static_cast<UvSource*>(source)->bindings->HandleDispatch();
+  return TRUE;
+}
+
+GSourceFuncs g_uv_source_funcs = {
+  UvSourcePrepare,
+  UvSourceCheck,
+  UvSourceDispatch,
+  nullptr
+};
+
+}  // namespace
+#endif
+
 NodeBindingsLinux::NodeBindingsLinux()
     : NodeBindings(),
-      epoll_(epoll_create(1)) {
+      epoll_(epoll_create(1)),
+      uv_source_(nullptr),
+      watcher_queue_changed_(false) {
   int backend_fd = uv_backend_fd(uv_loop_);
   struct epoll_event ev = { 0 };
   ev.events = EPOLLIN;
@@ -19,6 +65,12 @@ NodeBindingsLinux::NodeBindingsLinux()
 }
 
 NodeBindingsLinux::~NodeBindingsLinux() {
+#if defined(USE_GLIB)
+  if (uv_source_) {
+    g_source_destroy(uv_source_);
+    g_source_unref(uv_source_);
+  }
+#endif
 }
 
 void NodeBindingsLinux::RunMessageLoop() {
@@ -29,10 +81,38 @@ void NodeBindingsLinux::RunMessageLoop() {
   NodeBindings::RunMessageLoop();
 }
 
+int NodeBindingsLinux::HandlePrepare() {
+  if (watcher_queue_changed_)
+    return 0;
+
+  uv_update_time(uv_loop_);
+  return uv_backend_timeout(uv_loop_);
+}
+
+bool NodeBindingsLinux::HandleCheck(bool readable) {
+  if (!readable && HandlePrepare() != 0)
+    return false;
+
+  MarkWakeup();
+  return true;
+}
+
+void NodeBindingsLinux::HandleDispatch() {
+  watcher_queue_changed_ = false;
+  UvRunOnce();
+}
+
 // static
 void NodeBindingsLinux::OnWatcherQueueChanged(uv_loop_t* loop) {
   NodeBindingsLinux* self = static_cast<NodeBindingsLinux*>(loop->data);
 
+  // The watcher queue only changes on the main thread, so the source is
+  // prepared again before the GLib loop polls.
+  if (self->uv_source_) {
+    self->watcher_queue_changed_ = true;
+    return;
+  }
+
   // We need to break the io polling in the epoll thread when loop's watcher
   // queue changes, otherwise new events cannot be notified.
   self->WakeupEmbedThread();
@@ -49,6 +129,30 @@ void NodeBindingsLinux::PollEvents() {
   } while (r == -1 && errno == EINTR);
 }
 
+bool NodeBindingsLinux::WatchBackend() {
+#if defined(USE_GLIB)
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableNodeFdWatcher))
+    return false;
+
+  // Dispatch libuv's events straight from the GLib loop that runs the main
+  // thread's message pump, instead of bouncing them through the embed thread.
+  uv_source_ = g_source_new(&g_uv_source_funcs, sizeof(UvSource));
+  UvSource* uv_source = reinterpret_cast<UvSource*>(uv_source_);
+  uv_source->bindings = this;
+  uv_source->poll_fd.fd = uv_backend_fd(uv_loop_);
+  uv_source->poll_fd.events = G_IO_IN;
+  uv_source->poll_fd.revents = 0;
+  g_source_add_poll(uv_source_, &uv_source->poll_fd);
+  g_source_set_priority(uv_source_, G_PRIORITY_DEFAULT);
+  g_source_set_can_recurse(uv_source_, FALSE);
+  g_source_attach(uv_source_, g_main_context_default());
+  return true;
+#else
+  return false;
+#endif
+}
+
 // static
 NodeBindings* NodeBindings::Create() {
   return new NodeBindingsLinux();
@@ -8,6 +8,8 @@
 #include "atom/common/node_bindings.h"
 #include "base/compiler_specific.h"
 
+typedef struct _GSource GSource;
+
 namespace atom {
 
 class NodeBindingsLinux : public NodeBindings {
@@ -17,15 +19,31 @@ class NodeBindingsLinux : public NodeBindings {
 
   void RunMessageLoop() override;
 
+  // Internal methods used for processing the libuv source. HandlePrepare
+  // returns the timeout in milliseconds until libuv's loop has to run, or -1
+  // when it only has to run once its backend fd is readable.
+  int HandlePrepare();
+  bool HandleCheck(bool readable);
+  void HandleDispatch();
+
  private:
   // Called when uv's watcher queue changes.
   static void OnWatcherQueueChanged(uv_loop_t* loop);
 
   void PollEvents() override;
+  bool WatchBackend() override;
 
   // Epoll to poll for uv's backend fd.
   int epoll_;
 
+  // Source that watches uv's backend fd from the main thread's GLib loop,
+  // null when the events are polled in the embed thread.
+  GSource* uv_source_;
+
+  // The watcher queue is only flushed to the backend fd by uv_run, so the
+  // loop has to run again when it changes.
+  bool watcher_queue_changed_;
+
   DISALLOW_COPY_AND_ASSIGN(NodeBindingsLinux);
 };
 
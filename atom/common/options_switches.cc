@@ -112,6 +112,10 @@ const char kPpapiFlashVersion[] = "ppapi-flash-version";
 // Disable HTTP cache.
 const char kDisableHttpCache[] = "disable-http-cache";
 
+// Poll for node's events in a separate thread instead of watching them from
+// the main thread's message pump.
+const char kDisableNodeFdWatcher[] = "disable-node-fd-watcher";
+
 // The list of standard schemes.
 const char kStandardSchemes[] = "standard-schemes";
 
@@ -5,10 +5,11 @@
 #include "atom/renderer/content_settings_manager.h"
 
 #include <string>
+#include <utility>
 #include <vector>
 #include "atom/common/api/api_messages.h"
+#include "base/logging.h"
 #include "base/values.h"
-#include "components/content_settings/core/common/content_settings_pattern.h"
 #include "content/public/common/url_constants.h"
 #include "content/public/renderer/render_thread.h"
 #include "third_party/WebKit/public/web/WebDocument.h"
@@ -18,7 +19,8 @@
 
 namespace atom {
 
-ContentSettingsManager::ContentSettingsManager() {
+ContentSettingsManager::ContentSettingsManager()
+    : content_settings_version_(0) {
   content::RenderThread::Get()->AddObserver(this);
 }
 
@@ -52,6 +54,8 @@ bool ContentSettingsManager::OnControlMessageReceived(
   bool handled = true;
   IPC_BEGIN_MESSAGE_MAP(ContentSettingsManager, message)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettings, OnUpdateContentSettings)
+    IPC_MESSAGE_HANDLER(AtomMsg_UpdateContentSettingsDelta,
+                        OnUpdateContentSettingsDelta)
     IPC_MESSAGE_HANDLER(AtomMsg_UpdateWebKitPrefs, OnUpdateWebKitPrefs)
     IPC_MESSAGE_UNHANDLED(handled = false)
   IPC_END_MESSAGE_MAP()
@@ -64,14 +68,37 @@ void ContentSettingsManager::OnUpdateWebKitPrefs(
 }
 
 void ContentSettingsManager::OnUpdateContentSettings(
-    const base::DictionaryValue& content_settings) {
-  content_settings_ = content_settings.CreateDeepCopy();
+    uint64_t version,
+    const base::SharedMemoryHandle& snapshot,
+    uint32_t snapshot_size) {
+  // Swapping in the new snapshot unmaps the old one.
+  std::unique_ptr<ContentSettingsRules> rules =
+      ContentSettingsRules::CreateFromSharedMemory(snapshot, snapshot_size);
+  if (!rules) {
+    LOG(ERROR) << "Invalid content settings snapshot";
+    return;
+  }
+  content_settings_ = std::move(rules);
+  content_settings_version_ = version;
+}
+
+void ContentSettingsManager::OnUpdateContentSettingsDelta(
+    uint64_t base_version,
+    uint64_t version,
+    const base::ListValue& ops) {
+  // The browser only sends deltas on top of the version it last sent us.
+  if (!content_settings_ || content_settings_version_ != base_version) {
+    NOTREACHED();
+    return;
+  }
+  content_settings_->ApplyDelta(ops);
+  content_settings_version_ = version;
 }
 
 ContentSetting ContentSettingsManager::GetSetting(
-    GURL primary_url,
-    GURL secondary_url,
-    std::string content_type,
+    const GURL& primary_url,
+    const GURL& secondary_url,
+    const std::string& content_type,
     bool incognito) {
   bool default_value = true;
   if (content_type == "cookies")
@@ -83,74 +110,20 @@ ContentSetting ContentSettingsManager::GetSetting(
   else if (content_type == "runInsecureContent")
     default_value = web_preferences_.allow_running_insecure_content;
 
-  return GetContentSettingFromRules(primary_url,
-                                    secondary_url,
-                                    content_type,
-                                    default_value);
+  ContentSetting setting = default_value
+    ? ContentSetting::CONTENT_SETTING_ALLOW
+    : ContentSetting::CONTENT_SETTING_BLOCK;
+  if (content_settings_) {
+    content_settings_->GetSetting(
+        primary_url, secondary_url, content_type, &setting);
+  }
+  return setting;
 }
 
 std::vector<std::string> ContentSettingsManager::GetContentTypes() {
-  std::vector<std::string> content_types;
-  const base::DictionaryValue* settings = nullptr;
-  content_settings_->GetAsDictionary(&settings);
-  for (base::DictionaryValue::Iterator it(*settings);
-      !it.IsAtEnd();
-      it.Advance()) {
-    content_types.push_back(it.key());
-  }
-  return content_types;
+  if (!content_settings_)
+    return std::vector<std::string>();
+  return content_settings_->GetContentTypes();
 }
 
-ContentSetting ContentSettingsManager::GetContentSettingFromRules(
-    const GURL& primary_url,
-    const GURL& secondary_url,
-    const std::string& content_type,
-    const bool& default_value) {
-  ContentSetting result = default_value
-    ? ContentSetting::CONTENT_SETTING_ALLOW
-    : ContentSetting::CONTENT_SETTING_BLOCK;
-
-  base::ListValue* rules = nullptr;
-  if (!content_settings_->GetList(content_type, &rules))
-    return result;
-
-  // all rules are evaluated in order and the
-  // most specific matching rule will apply
-  for (base::ListValue::iterator it = rules->begin();
-       it != rules->end(); ++it) {
-    base::DictionaryValue* rule;
-    std::string pattern_string;
-    std::string setting_string;
-    if (!it->GetAsDictionary(&rule) ||
-        !rule->GetString("primaryPattern", &pattern_string) ||
-        !rule->GetString("setting", &setting_string)) {
-      // skip invalid entries
-      // TODO(bridiver) should also send an ipc error message
-      ++it;
-    } else {
-      std::string secondary_pattern_string;
-      rule->GetString("secondaryPattern", &secondary_pattern_string);
-
-      ContentSetting setting = result;
-      if (setting_string != "block" && setting_string != "deny") {
-        setting = ContentSetting::CONTENT_SETTING_ALLOW;
-      } else {
-        setting = ContentSetting::CONTENT_SETTING_BLOCK;
-      }
-
-      if (secondary_pattern_string == "[firstParty]") {
-        secondary_pattern_string = "[*.]" + primary_url.HostNoBrackets();
-      }
-
-      if (ContentSettingsPattern::FromString(
-            pattern_string).Matches(primary_url) &&
-          // if there is a secondary resource pattern it has to match as well
-          (secondary_pattern_string.empty() ||
-            ContentSettingsPattern::FromString(
-              secondary_pattern_string).Matches(secondary_url)))
-        result = setting;
-    }
-  }
-  return result;
-}
 }  // namespace atom
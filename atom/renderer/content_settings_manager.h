@@ -8,8 +8,9 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include "atom/renderer/content_settings_rules.h"
 #include "base/lazy_instance.h"
-#include "base/values.h"
+#include "base/memory/shared_memory_handle.h"
 #include "components/content_settings/core/common/content_settings.h"
 #include "content/public/common/web_preferences.h"
 #include "content/public/renderer/render_thread_observer.h"
@@ -18,7 +19,7 @@
 class GURL;
 
 namespace base {
-class DictionaryValue;
+class ListValue;
 }
 
 namespace blink {
@@ -35,35 +36,35 @@ class ContentSettingsManager : public content::RenderThreadObserver {
   static ContentSettingsManager* GetInstance();
   static GURL GetOriginOrURL(const blink::WebFrame* frame);
 
-  const base::DictionaryValue* content_settings() const
-    { return content_settings_.get(); };
+  bool has_content_settings() const { return !!content_settings_; }
 
   ContentSetting GetSetting(
-      GURL primary_url,
-      GURL secondary_url,
-      std::string resource_id,
+      const GURL& primary_url,
+      const GURL& secondary_url,
+      const std::string& content_type,
       bool incognito);
 
   std::vector<std::string> GetContentTypes();
 
  private:
-  ContentSetting GetContentSettingFromRules(
-    const GURL& primary_url,
-    const GURL& secondary_url,
-    const std::string& content_type,
-    const bool& enabled_per_settings);
-
   // content::RenderThreadObserver:
   bool OnControlMessageReceived(const IPC::Message& message) override;
 
   void OnUpdateWebKitPrefs(
       const content::WebPreferences& web_preferences);
   void OnUpdateContentSettings(
-      const base::DictionaryValue& content_settings);
+      uint64_t version,
+      const base::SharedMemoryHandle& snapshot,
+      uint32_t snapshot_size);
+  void OnUpdateContentSettingsDelta(
+      uint64_t base_version,
+      uint64_t version,
+      const base::ListValue& ops);
 
 
   content::WebPreferences web_preferences_;
-  std::unique_ptr<base::DictionaryValue> content_settings_;
+  std::unique_ptr<ContentSettingsRules> content_settings_;
+  uint64_t content_settings_version_;
 
   DISALLOW_COPY_AND_ASSIGN(ContentSettingsManager);
 };
@@ -0,0 +1,276 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#include "atom/renderer/content_settings_rules.h"
+
+#include <set>
+#include <utility>
+
+#include "base/memory/shared_memory.h"
+#include "base/values.h"
+#include "url/gurl.h"
+
+namespace atom {
+
+namespace {
+
+const char kFirstPartyPattern[] = "[firstParty]";
+
+}  // namespace
+
+struct ContentSettingsRules::Rule {
+  ContentSettingsPattern primary_pattern;
+  ContentSettingsPattern secondary_pattern;
+  bool has_secondary_pattern;
+  // The secondary pattern is [*.] plus the host of the primary url.
+  bool first_party;
+  ContentSetting setting;
+};
+
+class ContentSettingsRules::RuleSet {
+ public:
+  RuleSet() {}
+
+  // New rules take precedence over the existing ones.
+  void AddRules(const base::ListValue& list) {
+    for (const auto& item : list) {
+      const base::DictionaryValue* dict = nullptr;
+      std::string primary;
+      std::string setting;
+      // skip invalid entries
+      if (!item.GetAsDictionary(&dict) ||
+          !dict->GetString("primaryPattern", &primary) ||
+          !dict->GetString("setting", &setting))
+        continue;
+
+      Rule rule;
+      rule.primary_pattern = ContentSettingsPattern::FromString(primary);
+      if (!rule.primary_pattern.IsValid())
+        continue;
+
+      std::string secondary;
+      dict->GetString("secondaryPattern", &secondary);
+      rule.has_secondary_pattern = !secondary.empty();
+      rule.first_party = secondary == kFirstPartyPattern;
+      if (rule.has_secondary_pattern && !rule.first_party)
+        rule.secondary_pattern = ContentSettingsPattern::FromString(secondary);
+
+      rule.setting = (setting != "block" && setting != "deny")
+          ? CONTENT_SETTING_ALLOW
+          : CONTENT_SETTING_BLOCK;
+
+      const std::string& host = rule.primary_pattern.GetHost();
+      if (host.empty())
+        hostless_rules_.push_back(rules_.size());
+      else
+        rules_by_host_[host].push_back(rules_.size());
+      rules_.push_back(rule);
+    }
+  }
+
+  bool GetSetting(const GURL& primary_url,
+                  const GURL& secondary_url,
+                  ContentSetting* setting) const {
+    // Rule indexes grow with precedence, so the highest matching one wins.
+    size_t best = rules_.size();
+    FindLastMatch(hostless_rules_, primary_url, secondary_url, &best);
+
+    // Walk the domain suffixes of the host, "a.b.c", "b.c" and "c".
+    const std::string host = primary_url.HostNoBrackets();
+    size_t pos = 0;
+    while (pos != std::string::npos) {
+      auto it = rules_by_host_.find(host.substr(pos));
+      if (it != rules_by_host_.end())
+        FindLastMatch(it->second, primary_url, secondary_url, &best);
+      pos = host.find('.', pos);
+      if (pos != std::string::npos)
+        ++pos;
+    }
+
+    if (best == rules_.size())
+      return false;
+    *setting = rules_[best].setting;
+    return true;
+  }
+
+ private:
+  bool Matches(const Rule& rule,
+               const GURL& primary_url,
+               const GURL& secondary_url) const {
+    if (!rule.primary_pattern.Matches(primary_url))
+      return false;
+    if (!rule.has_secondary_pattern)
+      return true;
+    if (rule.first_party) {
+      return ContentSettingsPattern::FromString(
+          "[*.]" + primary_url.HostNoBrackets()).Matches(secondary_url);
+    }
+    return rule.secondary_pattern.Matches(secondary_url);
+  }
+
+  // |indexes| is in ascending order, |best| is rules_.size() if there is no
+  // match yet.
+  void FindLastMatch(const std::vector<size_t>& indexes,
+                     const GURL& primary_url,
+                     const GURL& secondary_url,
+                     size_t* best) const {
+    for (auto it = indexes.rbegin(); it != indexes.rend(); ++it) {
+      if (*best != rules_.size() && *it < *best)
+        return;
+      if (Matches(rules_[*it], primary_url, secondary_url)) {
+        *best = *it;
+        return;
+      }
+    }
+  }
+
+  std::vector<Rule> rules_;
+  std::unordered_map<std::string, std::vector<size_t>> rules_by_host_;
+  std::vector<size_t> hostless_rules_;
+
+  DISALLOW_COPY_AND_ASSIGN(RuleSet);
+};
+
+ContentSettingsRules::Overlay::Overlay() : replaced(false), removed(false) {
+}
+
+ContentSettingsRules::Overlay::~Overlay() {
+}
+
+// static
+std::unique_ptr<ContentSettingsRules>
+ContentSettingsRules::CreateFromSharedMemory(
+    const base::SharedMemoryHandle& handle,
+    size_t size) {
+  std::unique_ptr<base::SharedMemory> shared_memory(
+      new base::SharedMemory(handle, true));
+  if (!shared_memory->Map(size))
+    return nullptr;
+
+  std::unique_ptr<ContentSettingsRules> rules(
+      new ContentSettingsRules(std::move(shared_memory), size));
+  if (!rules->snapshot_.IsValid())
+    return nullptr;
+  return rules;
+}
+
+ContentSettingsRules::ContentSettingsRules(
+    std::unique_ptr<base::SharedMemory> shared_memory,
+    size_t size)
+    : shared_memory_(std::move(shared_memory)),
+      snapshot_(shared_memory_->memory(), size) {
+}
+
+ContentSettingsRules::~ContentSettingsRules() {
+}
+
+void ContentSettingsRules::ApplyDelta(const base::ListValue& ops) {
+  for (const auto& item : ops) {
+    const base::DictionaryValue* op_dict = nullptr;
+    std::string op;
+    std::string content_type;
+    if (!item.GetAsDictionary(&op_dict) ||
+        !op_dict->GetString("op", &op) ||
+        !op_dict->GetString("contentType", &content_type))
+      continue;
+
+    const base::ListValue* rules = nullptr;
+    if (op != "remove" && !op_dict->GetList("rules", &rules))
+      continue;
+
+    Overlay& overlay = overlays_[content_type];
+    if (op == "remove") {
+      overlay.replaced = true;
+      overlay.removed = true;
+      overlay.rules.reset(new RuleSet);
+      continue;
+    }
+
+    if (op == "replace" || !overlay.rules) {
+      overlay.replaced = overlay.replaced || op == "replace";
+      overlay.rules.reset(new RuleSet);
+    }
+    overlay.removed = false;
+    overlay.rules->AddRules(*rules);
+  }
+}
+
+bool ContentSettingsRules::GetSetting(const GURL& primary_url,
+                                      const GURL& secondary_url,
+                                      const std::string& content_type,
+                                      ContentSetting* setting) const {
+  // Rules from deltas are newer than any rule in the snapshot.
+  auto overlay = overlays_.find(content_type);
+  if (overlay != overlays_.end()) {
+    if (overlay->second.rules->GetSetting(primary_url, secondary_url,
+                                          setting))
+      return true;
+    if (overlay->second.replaced)
+      return false;
+  }
+
+  int content_type_index = snapshot_.FindContentType(content_type);
+  if (content_type_index < 0)
+    return false;
+
+  std::vector<uint32_t> rule_indexes;
+  snapshot_.GetCandidateRules(content_type_index,
+                              primary_url.HostNoBrackets(),
+                              &rule_indexes);
+  for (uint32_t rule_index : rule_indexes) {
+    const ContentSettingsSnapshot::Rule& rule =
+        snapshot_.GetRule(content_type_index, rule_index);
+    if (Matches(rule, primary_url, secondary_url)) {
+      *setting = static_cast<ContentSetting>(rule.setting);
+      return true;
+    }
+  }
+  return false;
+}
+
+std::vector<std::string> ContentSettingsRules::GetContentTypes() const {
+  std::set<std::string> content_types;
+  for (const auto& content_type : snapshot_.GetContentTypes())
+    content_types.insert(content_type);
+  for (const auto& overlay : overlays_) {
+    if (overlay.second.removed)
+      content_types.erase(overlay.first);
+    else
+      content_types.insert(overlay.first);
+  }
+  return std::vector<std::string>(content_types.begin(), content_types.end());
+}
+
+bool ContentSettingsRules::Matches(const ContentSettingsSnapshot::Rule& rule,
+                                   const GURL& primary_url,
+                                   const GURL& secondary_url) const {
+  if (!GetPattern(rule.primary_pattern_offset,
+                  rule.primary_pattern_length).Matches(primary_url))
+    return false;
+
+  // The secondary pattern is [*.] plus the host of the primary url.
+  if (rule.first_party) {
+    return ContentSettingsPattern::FromString(
+        "[*.]" + primary_url.HostNoBrackets()).Matches(secondary_url);
+  }
+
+  if (rule.secondary_pattern_length == 0)
+    return true;
+  return GetPattern(rule.secondary_pattern_offset,
+                    rule.secondary_pattern_length).Matches(secondary_url);
+}
+
+const ContentSettingsPattern& ContentSettingsRules::GetPattern(
+    uint32_t offset,
+    uint32_t length) const {
+  auto it = patterns_.find(offset);
+  if (it == patterns_.end()) {
+    it = patterns_.insert(std::make_pair(offset,
+        ContentSettingsPattern::FromString(
+            snapshot_.GetString(offset, length).as_string()))).first;
+  }
+  return it->second;
+}
+
+}  // namespace atom
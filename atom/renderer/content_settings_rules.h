@@ -0,0 +1,95 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by the MIT license that can be
+// found in the LICENSE file.
+
+#ifndef ATOM_RENDERER_CONTENT_SETTINGS_RULES_H_
+#define ATOM_RENDERER_CONTENT_SETTINGS_RULES_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "atom/common/content_settings_snapshot.h"
+#include "base/macros.h"
+#include "base/memory/shared_memory_handle.h"
+#include "components/content_settings/core/common/content_settings.h"
+#include "components/content_settings/core/common/content_settings_pattern.h"
+
+class GURL;
+
+namespace base {
+class ListValue;
+class SharedMemory;
+}
+
+namespace atom {
+
+// The content settings rules sent by the browser. The rules live in a
+// read-only shared memory snapshot, see ContentSettingsSnapshot, and only
+// the patterns of rules that were actually looked at are parsed and kept
+// here. Changes made after the snapshot arrive as deltas, which are compiled
+// into a small overlay on top of it until the browser sends a new snapshot.
+class ContentSettingsRules {
+ public:
+  // Returns null if |handle| can't be mapped or doesn't hold a valid
+  // snapshot.
+  static std::unique_ptr<ContentSettingsRules> CreateFromSharedMemory(
+      const base::SharedMemoryHandle& handle,
+      size_t size);
+
+  ~ContentSettingsRules();
+
+  // Applies the per content type operations computed by the browser on top
+  // of the snapshot, see AtomMsg_UpdateContentSettingsDelta.
+  void ApplyDelta(const base::ListValue& ops);
+
+  // Sets |setting| from the last rule for |content_type| that matches, as
+  // later rules take precedence. Returns false when none matches.
+  bool GetSetting(const GURL& primary_url,
+                  const GURL& secondary_url,
+                  const std::string& content_type,
+                  ContentSetting* setting) const;
+
+  std::vector<std::string> GetContentTypes() const;
+
+ private:
+  struct Rule;
+  class RuleSet;
+
+  // The rules of a content type that changed since the snapshot.
+  struct Overlay {
+    Overlay();
+    ~Overlay();
+
+    // The rules in the snapshot no longer apply.
+    bool replaced;
+    // The content type was removed.
+    bool removed;
+    std::unique_ptr<RuleSet> rules;
+  };
+
+  ContentSettingsRules(std::unique_ptr<base::SharedMemory> shared_memory,
+                       size_t size);
+
+  bool Matches(const ContentSettingsSnapshot::Rule& rule,
+               const GURL& primary_url,
+               const GURL& secondary_url) const;
+  const ContentSettingsPattern& GetPattern(uint32_t offset,
+                                           uint32_t length) const;
+
+  std::unique_ptr<base::SharedMemory> shared_memory_;
+  ContentSettingsSnapshot snapshot_;
+
+  // Parsed patterns keyed by their offset in the snapshot.
+  mutable std::unordered_map<uint32_t, ContentSettingsPattern> patterns_;
+
+  std::map<std::string, Overlay> overlays_;
+
+  DISALLOW_COPY_AND_ASSIGN(ContentSettingsRules);
+};
+
+}  // namespace atom
+
+#endif  // ATOM_RENDERER_CONTENT_SETTINGS_RULES_H_
@@ -4,6 +4,8 @@
 
 #include "brave/browser/api/navigation_controller.h"
 
+#include <vector>
+
 #include "atom/common/native_mate_converters/content_converter.h"
 #include "atom/common/native_mate_converters/gurl_converter.h"
 #include "atom/common/native_mate_converters/net_converter.h"
@@ -105,6 +107,18 @@ void NavigationController::GetEntryAtOffset(int offset, Arguments* args) const {
   args->Return(navigation_controller_->GetEntryAtOffset(offset));
 }
 
+void NavigationController::GetAllEntries(Arguments* args) const {
+  if (!CheckNavigationController(args))
+    return;
+
+  int count = navigation_controller_->GetEntryCount();
+  std::vector<content::NavigationEntry*> entries;
+  entries.reserve(count);
+  for (int i = 0; i < count; ++i)
+    entries.push_back(navigation_controller_->GetEntryAtIndex(i));
+  args->Return(entries);
+}
+
 void NavigationController::GetPendingEntry(Arguments* args) const {
   if (!CheckNavigationController(args))
     return;
@@ -226,6 +240,7 @@ void NavigationController::BuildPrototype(
       .SetMethod("getEntryCount", &NavigationController::GetEntryCount)
       .SetMethod("getEntryAtIndex", &NavigationController::GetEntryAtIndex)
       .SetMethod("getEntryAtOffset", &NavigationController::GetEntryAtOffset)
+      .SetMethod("getAllEntries", &NavigationController::GetAllEntries)
       .SetMethod("getPendingEntry", &NavigationController::GetPendingEntry)
       .SetMethod("getPendingEntryIndex",
           &NavigationController::GetPendingEntryIndex)
@@ -37,6 +37,8 @@ class NavigationController : public mate::Wrappable<NavigationController>,
   void GetEntryCount(mate::Arguments* args) const;
   void GetEntryAtIndex(int index, mate::Arguments* args) const;
   void GetEntryAtOffset(int offset, mate::Arguments* args) const;
+  // Returns all the entries in one array, in index order.
+  void GetAllEntries(mate::Arguments* args) const;
   void GetPendingEntry(mate::Arguments* args) const;
   void GetPendingEntryIndex(mate::Arguments* args) const;
   void GetTransientEntry(mate::Arguments* args) const;
@@ -10,6 +10,7 @@
 #include "content/public/browser/navigation_handle.h"
 #include "content/public/browser/render_frame_host.h"
 #include "content/public/browser/web_contents.h"
+#include "native_mate/dictionary.h"
 #include "native_mate/object_template_builder.h"
 
 namespace brave {
@@ -259,6 +260,62 @@ void NavigationHandle::IsValid(mate::Arguments* args) const {
   args->Return(navigation_handle_ != nullptr);
 }
 
+void NavigationHandle::ToJSON(mate::Arguments* args) const {
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(args->isolate());
+  dict.Set("isValid", navigation_handle_ != nullptr);
+  if (!navigation_handle_) {
+    args->Return(dict);
+    return;
+  }
+
+  // JSON.stringify passes the property name instead of options.
+  bool response_headers = false;
+  mate::Dictionary options;
+  if (args->GetNext(&options))
+    options.Get("responseHeaders", &response_headers);
+
+  content::NavigationHandle* handle = navigation_handle_;
+  dict.Set("url", handle->GetURL());
+  dict.Set("isInMainFrame", handle->IsInMainFrame());
+  dict.Set("isParentMainFrame", handle->IsParentMainFrame());
+  dict.Set("isRendererInitiated", handle->IsRendererInitiated());
+  dict.Set("frameTreeNodeId", handle->GetFrameTreeNodeId());
+  if (handle->GetParentFrame()) {
+    dict.Set("parentFrameTreeNodeId",
+             handle->GetParentFrame()->GetFrameTreeNodeId());
+  }
+  dict.Set("wasStartedFromContextMenu", handle->WasStartedFromContextMenu());
+  dict.Set("searchableFormURL", handle->GetSearchableFormURL());
+  dict.Set("searchableFormEncoding", handle->GetSearchableFormEncoding());
+  dict.Set("reloadType", handle->GetReloadType());
+  dict.Set("restoreType", handle->GetRestoreType());
+  dict.Set("isPost", handle->IsPost());
+  dict.Set("referrer", handle->GetReferrer().url);
+  dict.Set("hasUserGesture", handle->HasUserGesture());
+  dict.Set("pageTransition", handle->GetPageTransition());
+  dict.Set("isExternalProtocol", handle->IsExternalProtocol());
+  dict.Set("netErrorCode", static_cast<int>(handle->GetNetErrorCode()));
+  dict.Set("isSameDocument", handle->IsSameDocument());
+  dict.Set("wasServerRedirect", handle->WasServerRedirect());
+  dict.Set("redirectChain", handle->GetRedirectChain());
+  dict.Set("isErrorPage", handle->IsErrorPage());
+
+  bool has_committed = handle->HasCommitted();
+  dict.Set("hasCommitted", has_committed);
+  dict.Set("hasSubframeNavigationEntryCommitted",
+           has_committed && handle->HasSubframeNavigationEntryCommitted());
+  dict.Set("didReplaceEntry", has_committed && handle->DidReplaceEntry());
+  dict.Set("shouldUpdateHistory",
+           has_committed && handle->ShouldUpdateHistory());
+  dict.Set("previousURL",
+           has_committed ? handle->GetPreviousURL() : GURL());
+
+  if (response_headers)
+    dict.Set("responseHeaders", handle->GetResponseHeaders());
+
+  args->Return(dict);
+}
+
 // static
 mate::Handle<NavigationHandle> NavigationHandle::CreateFrom(
     v8::Isolate* isolate,
@@ -303,7 +360,8 @@ void NavigationHandle::BuildPrototype(
       .SetMethod("shouldUpdateHistory", &NavigationHandle::ShouldUpdateHistory)
       .SetMethod("getPreviousURL", &NavigationHandle::GetPreviousURL)
       .SetMethod("getResponseHeaders", &NavigationHandle::GetResponseHeaders)
-      .SetMethod("isValid", &NavigationHandle::IsValid);
+      .SetMethod("isValid", &NavigationHandle::IsValid)
+      .SetMethod("toJSON", &NavigationHandle::ToJSON);
 }
 
 }  // namespace brave
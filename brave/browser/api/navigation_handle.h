@@ -58,6 +58,10 @@ class NavigationHandle : public mate::Wrappable<NavigationHandle>,
   void GetResponseHeaders(mate::Arguments* args) const;
   void IsValid(mate::Arguments* args) const;
 
+  // Returns the values of all the getters above in one object. The response
+  // headers are only included when |args| has {responseHeaders: true}.
+  void ToJSON(mate::Arguments* args) const;
+
  protected:
   explicit NavigationHandle(v8::Isolate* isolate,
                             content::NavigationHandle* handle);
@@ -4,11 +4,22 @@
 
 #include "brave/common/extensions/asar_source_map.h"
 
+#include <map>
+#include <memory>
+#include <unordered_map>
+
+#include "atom/common/asar/archive.h"
 #include "atom/common/asar/asar_util.h"
-#include "base/callback.h"
-#include "base/bind.h"
+#include "base/files/file.h"
 #include "base/files/file_util.h"
+#include "base/hash.h"
+#include "base/json/string_escape.h"
+#include "base/lazy_instance.h"
+#include "base/strings/string_piece.h"
 #include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "brave/common/extensions/module_code_cache.h"
 #include "gin/converter.h"
 
 namespace brave {
@@ -17,17 +28,115 @@ namespace {
 
 static const char commonjs[] = "muon/module_system/commonjs";
 
-bool IsAsarPath(const base::FilePath& path) {
-  base::FilePath archive;
-  base::FilePath relative;
-  return asar::GetAsarArchivePath(path, &archive, &relative);
+// Names ModuleSystem declares in the scope it wraps module sources in. A
+// compiled module runs outside of that wrapper, so they are passed to it
+// as arguments. Names the running ModuleSystem does not declare are passed
+// as undefined.
+const char* const kModuleScopeNames[] = {
+  "define", "requireNative", "requireAsync", "exports", "privates",
+  "apiBridge", "bindingUtil", "getInternalApi", "$Array", "$Function",
+  "$JSON", "$Object", "$RegExp", "$String", "$Error", "$Promise",
+};
+
+// Returns "[a, b, ...]" with the values of kModuleScopeNames.
+std::string GetModuleScopeArray() {
+  std::string array = "[";
+  for (const char* name : kModuleScopeNames) {
+    if (array.size() > 1)
+      array += ", ";
+    array += std::string("typeof ") + name + " === 'undefined' ? undefined : " +
+        name;
+  }
+  return array + "]";
+}
+
+// Returns "a, b, ..." with kModuleScopeNames.
+std::string GetModuleScopeParameters() {
+  std::string parameters;
+  for (const char* name : kModuleScopeNames) {
+    if (!parameters.empty())
+      parameters += ", ";
+    parameters += name;
+  }
+  return parameters;
+}
+
+// The source of a module, |contents| either points into a mapped |archive| or
+// into |data|.
+struct ModuleSource {
+  ModuleSource() {}
+
+  std::shared_ptr<asar::Archive> archive;
+  std::string data;
+  base::StringPiece contents;
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ModuleSource);
+};
+
+// Exposes a module source in a mapped archive to V8 without copying it.
+class ArchiveSourceResource
+    : public v8::String::ExternalOneByteStringResource {
+ public:
+  ArchiveSourceResource(std::shared_ptr<asar::Archive> archive,
+                        const base::StringPiece& contents)
+      : archive_(archive), contents_(contents) {}
+  ~ArchiveSourceResource() override {}
+
+  const char* data() const override { return contents_.data(); }
+  size_t length() const override { return contents_.length(); }
+
+ private:
+  std::shared_ptr<asar::Archive> archive_;
+  base::StringPiece contents_;
+
+  DISALLOW_COPY_AND_ASSIGN(ArchiveSourceResource);
+};
+
+bool ReadModuleSource(const base::FilePath& path, ModuleSource* source) {
+  if (asar::GetFileContents(path, &source->archive, &source->contents))
+    return true;
+
+  if (!asar::ReadFileToString(path, &source->data))
+    return false;
+
+  source->contents = source->data;
+  return true;
+}
+
+v8::Local<v8::String> ModuleSourceToV8(v8::Isolate* isolate,
+                                       const ModuleSource& source) {
+  // External one-byte strings must be latin1, so only mapped sources that are
+  // plain ASCII can be handed to V8 directly.
+  if (source.archive && base::IsStringASCII(source.contents)) {
+    v8::Local<v8::String> result;
+    if (v8::String::NewExternalOneByte(
+            isolate,
+            new ArchiveSourceResource(source.archive, source.contents))
+            .ToLocal(&result))
+      return result;
+  }
+  return gin::StringToV8(isolate, source.contents);
 }
 
-bool ReadFromPath(
-    base::Callback<bool(const base::FilePath& path, std::string* contents)>,
-    const base::FilePath& file,
-    const base::FilePath& path,
-    std::string* source) {
+// Checks that |path| is a file without reading it, for files in an asar
+// archive this is a lookup in the archive's index.
+bool ModuleFileExists(const base::FilePath& path) {
+  base::FilePath asar_path, relative_path;
+  if (asar::GetAsarArchivePath(path, &asar_path, &relative_path)) {
+    std::shared_ptr<asar::Archive> archive =
+        asar::GetOrCreateAsarArchive(asar_path);
+    asar::Archive::FileInfo info;
+    return archive && archive->GetFileInfo(relative_path, &info);
+  }
+
+  base::File::Info info;
+  return base::GetFileInfo(path, &info) && !info.is_directory;
+}
+
+bool ResolveFromPath(const base::FilePath& file,
+                     const base::FilePath& path,
+                     base::FilePath* resolved) {
   base::FilePath file_path = path.Append(file);
   if (!file_path.MatchesExtension(FILE_PATH_LITERAL(".js")))
     file_path = file_path.AddExtension(FILE_PATH_LITERAL("js"));
@@ -42,29 +151,45 @@ bool ReadFromPath(
       .Append(file)
       .AddExtension(FILE_PATH_LITERAL("js"));
 
-  return asar::ReadFileToString(file_path, source) ||
-      asar::ReadFileToString(module_path1, source) ||
-      asar::ReadFileToString(module_path2, source);
+  for (const base::FilePath& candidate :
+       { file_path, module_path1, module_path2 }) {
+    if (ModuleFileExists(candidate)) {
+      *resolved = candidate;
+      return true;
+    }
+  }
+  return false;
 }
 
-bool ReadFromSearchPaths(const std::vector<base::FilePath>& search_paths,
-                        const base::FilePath& file_path,
-                        std::string* source) {
+// Resolves |file_path| against |search_paths| in order. |cacheable| is set
+// when every location looked at is inside an asar archive, whose contents
+// don't change, so the result stays valid for the lifetime of the process.
+bool ResolveFromSearchPaths(const std::vector<base::FilePath>& search_paths,
+                            const base::FilePath& file_path,
+                            base::FilePath* resolved,
+                            bool* cacheable) {
+  *cacheable = true;
   for (size_t i = 0; i < search_paths.size(); ++i) {
-    if (IsAsarPath(search_paths[i])) {
-      if (!ReadFromPath(base::Bind(&asar::ReadFileToString),
-          file_path, search_paths[i], source))
-        continue;
-    } else {
-      if (!ReadFromPath(base::Bind(&base::ReadFileToString),
-          file_path, search_paths[i], source))
-        continue;
-    }
-    return true;
+    base::FilePath asar_path, relative_path;
+    if (!asar::GetAsarArchivePath(search_paths[i].Append(file_path),
+                                  &asar_path, &relative_path))
+      *cacheable = false;
+    if (ResolveFromPath(file_path, search_paths[i], resolved))
+      return true;
   }
   return false;
 }
 
+typedef std::map<std::vector<base::FilePath>, ModuleResolutionCache*>
+    ModuleResolutionCacheMap;
+
+// Caches are shared by every AsarSourceMap with the same search paths, which
+// includes the JavascriptEnvironment of each V8WorkerThread.
+base::LazyInstance<base::Lock>::Leaky g_resolution_caches_lock =
+    LAZY_INSTANCE_INITIALIZER;
+base::LazyInstance<ModuleResolutionCacheMap>::Leaky g_resolution_caches =
+    LAZY_INSTANCE_INITIALIZER;
+
 const base::FilePath GetFilePath(const std::string& name) {
   std::vector<std::string> components = base::SplitString(
       name,
@@ -101,9 +226,66 @@ const base::FilePath GetFilePath(const std::string& name) {
 
 }  // namespace
 
+// Maps module file paths to the file they resolve to, or to an empty path if
+// they couldn't be found in any of the search paths. Only resolutions made
+// entirely inside asar archives are kept, files on disk may come and go.
+class ModuleResolutionCache
+    : public base::RefCountedThreadSafe<ModuleResolutionCache> {
+ public:
+  static scoped_refptr<ModuleResolutionCache> GetForSearchPaths(
+      const std::vector<base::FilePath>& search_paths) {
+    base::AutoLock auto_lock(g_resolution_caches_lock.Get());
+    ModuleResolutionCache*& cache = g_resolution_caches.Get()[search_paths];
+    if (!cache)
+      cache = new ModuleResolutionCache(search_paths);
+    return make_scoped_refptr(cache);
+  }
+
+  bool Resolve(const base::FilePath& file_path, base::FilePath* resolved) {
+    {
+      base::AutoLock auto_lock(lock_);
+      auto it = resolved_.find(file_path.value());
+      if (it != resolved_.end()) {
+        *resolved = it->second;
+        return !resolved->empty();
+      }
+    }
+
+    base::FilePath result;
+    bool cacheable;
+    ResolveFromSearchPaths(search_paths_, file_path, &result, &cacheable);
+    *resolved = result;
+    if (!cacheable)
+      return !result.empty();
+
+    base::AutoLock auto_lock(lock_);
+    resolved_[file_path.value()] = result;
+    return !result.empty();
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<ModuleResolutionCache>;
+
+  explicit ModuleResolutionCache(
+      const std::vector<base::FilePath>& search_paths)
+      : search_paths_(search_paths) {
+    // Owned by |g_resolution_caches| for the lifetime of the process.
+    AddRef();
+  }
+  ~ModuleResolutionCache() {}
+
+  const std::vector<base::FilePath> search_paths_;
+
+  base::Lock lock_;
+  std::unordered_map<base::FilePath::StringType, base::FilePath> resolved_;
+
+  DISALLOW_COPY_AND_ASSIGN(ModuleResolutionCache);
+};
+
 AsarSourceMap::AsarSourceMap(
     const std::vector<base::FilePath>& search_paths)
-    : search_paths_(search_paths) {
+    : resolution_cache_(
+          ModuleResolutionCache::GetForSearchPaths(search_paths)) {
 }
 
 AsarSourceMap::~AsarSourceMap() {
@@ -112,19 +294,25 @@ AsarSourceMap::~AsarSourceMap() {
 v8::Local<v8::String> AsarSourceMap::GetSource(
     v8::Isolate* isolate,
     const std::string& name) const {
-  std::string source;
-  if (ReadFromSearchPaths(search_paths_, GetFilePath(name), &source)) {
-    if (name != commonjs) {
-      source =
-          "const fn = function (require, module, console) { " + source + " };"
-          "require('" +
-            commonjs +
-          "').require(fn, exports, '" +
-          GetFilePath(name).AsUTF8Unsafe() +
-          "', this);";
-    }
-
-    return gin::StringToV8(isolate, source);
+  base::FilePath resolved;
+  if (name == commonjs) {
+    ModuleSource source;
+    if (resolution_cache_->Resolve(GetFilePath(name), &resolved) &&
+        ReadModuleSource(resolved, &source))
+      return ModuleSourceToV8(isolate, source);
+  } else if (resolution_cache_->Resolve(GetFilePath(name), &resolved)) {
+    // The module itself is compiled by commonjs through module_compiler so
+    // it can use the code cache.
+    return gin::StringToV8(isolate,
+        "require('" +
+          std::string(commonjs) +
+        "').requireCompiled(" +
+        base::GetQuotedJSONString(name) +
+        ", exports, " +
+        base::GetQuotedJSONString(GetFilePath(name).AsUTF8Unsafe()) +
+        ", this, " +
+        GetModuleScopeArray() +
+        ");");
   }
 
   NOTREACHED() << "No module is registered with name \"" << name << "\"";
@@ -132,8 +320,69 @@ v8::Local<v8::String> AsarSourceMap::GetSource(
 }
 
 bool AsarSourceMap::Contains(const std::string& name) const {
-  std::string source;
-  return ReadFromSearchPaths(search_paths_, GetFilePath(name), &source);
+  base::FilePath resolved;
+  return resolution_cache_->Resolve(GetFilePath(name), &resolved);
+}
+
+v8::Local<v8::Value> AsarSourceMap::CompileModule(
+    v8::Local<v8::Context> context,
+    const std::string& name) const {
+  v8::Isolate* isolate = context->GetIsolate();
+  base::FilePath resolved;
+  ModuleSource source;
+  if (!resolution_cache_->Resolve(GetFilePath(name), &resolved) ||
+      !ReadModuleSource(resolved, &source))
+    return v8::Local<v8::Value>();
+
+  // Strict like the ModuleSystem wrapper the module used to be inlined in.
+  v8::Local<v8::String> code = v8::String::Concat(
+      v8::String::Concat(gin::StringToV8(isolate,
+          "(function (require, module, console, " +
+            GetModuleScopeParameters() +
+          ") { 'use strict'; "),
+          ModuleSourceToV8(isolate, source)),
+      gin::StringToV8(isolate, "\n})"));
+  v8::ScriptOrigin origin(gin::StringToV8(isolate, resolved.AsUTF8Unsafe()));
+
+  // Caches are tagged with the hash of the module contents, so the cache of
+  // an updated archive is never consumed.
+  std::string path = resolved.AsUTF8Unsafe();
+  uint32_t hash = base::Hash(source.contents.data(), source.contents.size());
+  ModuleCodeCache* code_cache = ModuleCodeCache::GetInstance();
+
+  std::string cached_data;
+  v8::ScriptCompiler::CompileOptions options;
+  std::unique_ptr<v8::ScriptCompiler::Source> script_source;
+  if (code_cache->Get(path, hash, &cached_data)) {
+    options = v8::ScriptCompiler::kConsumeCodeCache;
+    script_source.reset(new v8::ScriptCompiler::Source(code, origin,
+        new v8::ScriptCompiler::CachedData(
+            reinterpret_cast<const uint8_t*>(cached_data.data()),
+            static_cast<int>(cached_data.size()))));
+  } else {
+    options = v8::ScriptCompiler::kProduceCodeCache;
+    script_source.reset(new v8::ScriptCompiler::Source(code, origin));
+  }
+
+  v8::Local<v8::Script> script;
+  if (!v8::ScriptCompiler::Compile(context, script_source.get(), options)
+          .ToLocal(&script))
+    return v8::Local<v8::Value>();
+
+  const v8::ScriptCompiler::CachedData* data =
+      script_source->GetCachedData();
+  if (options == v8::ScriptCompiler::kConsumeCodeCache) {
+    if (data->rejected)
+      code_cache->Remove(path);
+  } else if (data) {
+    code_cache->Put(path, hash, std::string(
+        reinterpret_cast<const char*>(data->data), data->length));
+  }
+
+  v8::Local<v8::Value> fn;
+  if (!script->Run(context).ToLocal(&fn))
+    return v8::Local<v8::Value>();
+  return fn;
 }
 
 }  // namespace brave
@@ -10,11 +10,14 @@
 
 #include "base/compiler_specific.h"
 #include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
 #include "extensions/renderer/source_map.h"
 #include "v8/include/v8.h"
 
 namespace brave {
 
+class ModuleResolutionCache;
+
 class AsarSourceMap : public extensions::SourceMap {
  public:
   explicit AsarSourceMap(const std::vector<base::FilePath>& search_paths);
@@ -24,8 +27,14 @@ class AsarSourceMap : public extensions::SourceMap {
                                  const std::string& name) const override;
   bool Contains(const std::string& name) const override;
 
+  // Compiles the commonjs function wrapping module |name|, consuming or
+  // producing a V8 code cache for it. Returns an empty handle on failure.
+  v8::Local<v8::Value> CompileModule(v8::Local<v8::Context> context,
+                                     const std::string& name) const;
+
  private:
-  std::vector<base::FilePath> search_paths_;
+  // Shared with other source maps using the same search paths.
+  scoped_refptr<ModuleResolutionCache> resolution_cache_;
 
   DISALLOW_COPY_AND_ASSIGN(AsarSourceMap);
 };
@@ -0,0 +1,254 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/extensions/module_code_cache.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_enumerator.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/md5.h"
+#include "base/memory/singleton.h"
+#include "base/sequenced_task_runner.h"
+#include "base/task_scheduler/post_task.h"
+
+namespace brave {
+
+namespace {
+
+// Caches of the modules used most recently are kept in memory up to this
+// size, the rest are loaded from disk again when they are needed.
+const size_t kMaxMemoryCacheSize = 8 * 1024 * 1024;
+
+// Cache files written least recently are deleted past this size.
+const int64_t kMaxCacheDirectorySize = 32 * 1024 * 1024;
+
+// A cache file is the header, the module path and the V8 cached data.
+struct CacheFileHeader {
+  uint32_t hash;
+  uint32_t path_length;
+};
+
+std::string SerializeCacheFile(const std::string& path,
+                               uint32_t hash,
+                               const std::string& data) {
+  CacheFileHeader header;
+  header.hash = hash;
+  header.path_length = static_cast<uint32_t>(path.size());
+  std::string contents(reinterpret_cast<const char*>(&header), sizeof(header));
+  contents.append(path);
+  contents.append(data);
+  return contents;
+}
+
+bool ParseCacheFile(const std::string& contents,
+                    std::string* path,
+                    uint32_t* hash,
+                    std::string* data) {
+  CacheFileHeader header;
+  if (contents.size() < sizeof(header))
+    return false;
+  memcpy(&header, contents.data(), sizeof(header));
+  if (contents.size() - sizeof(header) <= header.path_length)
+    return false;
+
+  *hash = header.hash;
+  path->assign(contents, sizeof(header), header.path_length);
+  data->assign(contents, sizeof(header) + header.path_length,
+               std::string::npos);
+  return true;
+}
+
+void WriteCacheFile(const base::FilePath& file_path,
+                    const std::string& contents) {
+  if (!base::CreateDirectory(file_path.DirName()))
+    return;
+  base::ImportantFileWriter::WriteFileAtomically(file_path, contents);
+}
+
+void DeleteCacheFile(const base::FilePath& file_path) {
+  base::DeleteFile(file_path, false);
+}
+
+}  // namespace
+
+// static
+ModuleCodeCache* ModuleCodeCache::GetInstance() {
+  return base::Singleton<ModuleCodeCache>::get();
+}
+
+ModuleCodeCache::ModuleCodeCache()
+    : file_task_runner_(base::CreateSequencedTaskRunnerWithTraits(
+          {base::MayBlock(), base::TaskPriority::BACKGROUND,
+           base::TaskShutdownBehavior::SKIP_ON_SHUTDOWN})),
+      entries_(base::MRUCache<std::string, Entry>::NO_AUTO_EVICT),
+      entries_size_(0) {
+}
+
+ModuleCodeCache::~ModuleCodeCache() {
+}
+
+void ModuleCodeCache::SetCacheDirectory(const base::FilePath& cache_dir) {
+  {
+    base::AutoLock auto_lock(lock_);
+    cache_dir_ = cache_dir;
+  }
+
+  file_task_runner_->PostTask(FROM_HERE,
+      base::Bind(&ModuleCodeCache::LoadCacheDirectory, base::Unretained(this),
+                 cache_dir));
+}
+
+bool ModuleCodeCache::Get(const std::string& path,
+                          uint32_t hash,
+                          std::string* data) {
+  base::AutoLock auto_lock(lock_);
+  auto it = entries_.Get(path);
+  if (it != entries_.end()) {
+    if (it->second.hash != hash)
+      return false;
+    *data = it->second.data;
+    return true;
+  }
+
+  base::FilePath file_path = GetCacheFilePath(path);
+  if (!file_path.empty() && pending_loads_.insert(path).second) {
+    file_task_runner_->PostTask(FROM_HERE,
+        base::Bind(&ModuleCodeCache::LoadCacheFile, base::Unretained(this),
+                   file_path, path));
+  }
+  return false;
+}
+
+void ModuleCodeCache::Put(const std::string& path,
+                          uint32_t hash,
+                          const std::string& data) {
+  base::AutoLock auto_lock(lock_);
+  AddEntry(path, Entry{hash, data});
+
+  // There is one file per path, so the cache of the previous version of the
+  // module is overwritten.
+  base::FilePath file_path = GetCacheFilePath(path);
+  if (!file_path.empty()) {
+    file_task_runner_->PostTask(FROM_HERE,
+        base::Bind(&WriteCacheFile, file_path,
+                   SerializeCacheFile(path, hash, data)));
+  }
+}
+
+void ModuleCodeCache::Remove(const std::string& path) {
+  base::AutoLock auto_lock(lock_);
+  auto it = entries_.Peek(path);
+  if (it != entries_.end()) {
+    entries_size_ -= it->second.data.size();
+    entries_.Erase(it);
+  }
+
+  base::FilePath file_path = GetCacheFilePath(path);
+  if (!file_path.empty()) {
+    file_task_runner_->PostTask(FROM_HERE,
+        base::Bind(&DeleteCacheFile, file_path));
+  }
+}
+
+void ModuleCodeCache::LoadCacheDirectory(const base::FilePath& cache_dir) {
+  struct CacheFile {
+    base::FilePath path;
+    base::Time last_modified;
+    int64_t size;
+  };
+
+  std::vector<CacheFile> files;
+  base::FileEnumerator enumerator(cache_dir, false,
+                                  base::FileEnumerator::FILES);
+  for (base::FilePath path = enumerator.Next(); !path.empty();
+       path = enumerator.Next()) {
+    base::FileEnumerator::FileInfo info = enumerator.GetInfo();
+    files.push_back({path, info.GetLastModifiedTime(), info.GetSize()});
+  }
+
+  // Most recently written first, which are the ones most likely to be used.
+  std::sort(files.begin(), files.end(),
+            [](const CacheFile& a, const CacheFile& b) {
+              return a.last_modified > b.last_modified;
+            });
+
+  int64_t directory_size = 0;
+  int64_t loaded_size = 0;
+  for (const CacheFile& file : files) {
+    directory_size += file.size;
+    if (directory_size > kMaxCacheDirectorySize) {
+      DeleteCacheFile(file.path);
+      continue;
+    }
+
+    if (loaded_size + file.size > static_cast<int64_t>(kMaxMemoryCacheSize))
+      continue;
+
+    std::string contents;
+    std::string path;
+    Entry entry;
+    if (!base::ReadFileToString(file.path, &contents) ||
+        !ParseCacheFile(contents, &path, &entry.hash, &entry.data)) {
+      DeleteCacheFile(file.path);
+      continue;
+    }
+    loaded_size += file.size;
+    AddLoadedEntry(path, std::move(entry));
+  }
+}
+
+void ModuleCodeCache::LoadCacheFile(const base::FilePath& file_path,
+                                    const std::string& path) {
+  std::string contents;
+  std::string loaded_path;
+  Entry entry;
+  bool loaded = base::ReadFileToString(file_path, &contents) &&
+      ParseCacheFile(contents, &loaded_path, &entry.hash, &entry.data) &&
+      loaded_path == path;
+
+  if (loaded)
+    AddLoadedEntry(path, std::move(entry));
+
+  base::AutoLock auto_lock(lock_);
+  pending_loads_.erase(path);
+}
+
+void ModuleCodeCache::AddLoadedEntry(const std::string& path, Entry entry) {
+  base::AutoLock auto_lock(lock_);
+  if (entries_.Peek(path) == entries_.end())
+    AddEntry(path, std::move(entry));
+}
+
+void ModuleCodeCache::AddEntry(const std::string& path, Entry entry) {
+  lock_.AssertAcquired();
+  auto it = entries_.Peek(path);
+  if (it != entries_.end())
+    entries_size_ -= it->second.data.size();
+  entries_size_ += entry.data.size();
+  entries_.Put(path, std::move(entry));
+
+  // Keep at least the entry that was just added.
+  while (entries_size_ > kMaxMemoryCacheSize && entries_.size() > 1) {
+    auto oldest = entries_.rbegin();
+    entries_size_ -= oldest->second.data.size();
+    entries_.Erase(oldest);
+  }
+}
+
+base::FilePath ModuleCodeCache::GetCacheFilePath(
+    const std::string& path) const {
+  lock_.AssertAcquired();
+  if (cache_dir_.empty())
+    return base::FilePath();
+  return cache_dir_.AppendASCII(base::MD5String(path));
+}
+
+}  // namespace brave
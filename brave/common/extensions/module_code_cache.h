@@ -0,0 +1,91 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
+#define BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <set>
+#include <string>
+
+#include "base/containers/mru_cache.h"
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+
+namespace base {
+template <typename T>
+struct DefaultSingletonTraits;
+class SequencedTaskRunner;
+}
+
+namespace brave {
+
+// Process wide store of V8 code caches for module_system scripts, shared by
+// the JavascriptEnvironment of the browser and of every V8WorkerThread.
+// There is one entry per module path, tagged with the hash of the module
+// source it was produced from. Entries are kept in a bounded in-memory cache
+// and persisted to |cache_dir_| in the background. The disk is only touched
+// on |file_task_runner_|.
+class ModuleCodeCache {
+ public:
+  static ModuleCodeCache* GetInstance();
+
+  // Sets the directory the caches are persisted to, nothing is persisted
+  // until this is called. Trims the directory to its size limit and loads
+  // the most recently written caches in the background.
+  void SetCacheDirectory(const base::FilePath& cache_dir);
+
+  // Gets the cached data for the module at |path| if it was produced from a
+  // source with |hash|. Only memory is looked up, a miss loads the cache file
+  // of |path| in the background for the next lookup.
+  bool Get(const std::string& path, uint32_t hash, std::string* data);
+
+  // Stores the cached data for |path|, replacing the one of any other version
+  // of the module, and writes it to disk in the background.
+  void Put(const std::string& path, uint32_t hash, const std::string& data);
+
+  // Drops the cached data for |path|, e.g. after V8 rejected it.
+  void Remove(const std::string& path);
+
+ private:
+  friend struct base::DefaultSingletonTraits<ModuleCodeCache>;
+
+  struct Entry {
+    uint32_t hash;
+    std::string data;
+  };
+
+  ModuleCodeCache();
+  ~ModuleCodeCache();
+
+  // Run on |file_task_runner_|.
+  void LoadCacheDirectory(const base::FilePath& cache_dir);
+  void LoadCacheFile(const base::FilePath& file_path, const std::string& path);
+
+  // Adds an entry read from disk unless a newer one was put meanwhile.
+  void AddLoadedEntry(const std::string& path, Entry entry);
+  void AddEntry(const std::string& path, Entry entry);
+
+  base::FilePath GetCacheFilePath(const std::string& path) const;
+
+  scoped_refptr<base::SequencedTaskRunner> file_task_runner_;
+
+  base::Lock lock_;
+  base::FilePath cache_dir_;
+  base::MRUCache<std::string, Entry> entries_;
+  // Size of the data in |entries_|.
+  size_t entries_size_;
+  // Paths with a cache file load pending.
+  std::set<std::string> pending_loads_;
+
+  DISALLOW_COPY_AND_ASSIGN(ModuleCodeCache);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_MODULE_CODE_CACHE_H_
@@ -0,0 +1,53 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <string>
+
+#include "brave/common/extensions/module_compiler_bindings.h"
+
+#include "brave/common/extensions/asar_source_map.h"
+#include "extensions/renderer/script_context.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+ModuleCompilerBindings::ModuleCompilerBindings(
+        extensions::ScriptContext* context,
+        const AsarSourceMap* source_map)
+    : extensions::ObjectBackedNativeHandler(context),
+      source_map_(source_map) {
+  RouteFunction("compile",
+      base::Bind(&ModuleCompilerBindings::Compile, base::Unretained(this)));
+}
+
+ModuleCompilerBindings::~ModuleCompilerBindings() {
+}
+
+void ModuleCompilerBindings::Compile(
+    const v8::FunctionCallbackInfo<v8::Value>& args) {
+  if (args.Length() != 1 || !args[0]->IsString()) {
+    GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+        GetIsolate(), "Invalid arguments to 'compile'"));
+    return;
+  }
+
+  std::string name(*v8::String::Utf8Value(args[0]));
+  v8::TryCatch try_catch(GetIsolate());
+  v8::Local<v8::Value> fn =
+      source_map_->CompileModule(context()->v8_context(), name);
+  if (try_catch.HasCaught()) {
+    try_catch.ReThrow();
+    return;
+  }
+
+  if (fn.IsEmpty()) {
+    GetIsolate()->ThrowException(v8::String::NewFromUtf8(
+        GetIsolate(), ("Cannot compile module '" + name + "'").c_str()));
+    return;
+  }
+
+  args.GetReturnValue().Set(fn);
+}
+
+}  // namespace brave
@@ -0,0 +1,35 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_EXTENSIONS_MODULE_COMPILER_BINDINGS_H_
+#define BRAVE_COMMON_EXTENSIONS_MODULE_COMPILER_BINDINGS_H_
+
+#include "base/compiler_specific.h"
+#include "base/macros.h"
+#include "extensions/renderer/object_backed_native_handler.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+class AsarSourceMap;
+
+// Compiles commonjs modules with the V8 code cache, see
+// AsarSourceMap::CompileModule.
+class ModuleCompilerBindings : public extensions::ObjectBackedNativeHandler {
+ public:
+  ModuleCompilerBindings(extensions::ScriptContext* context,
+      const AsarSourceMap* source_map);
+  ~ModuleCompilerBindings() override;
+
+ private:
+  void Compile(const v8::FunctionCallbackInfo<v8::Value>& args);
+
+  const AsarSourceMap* source_map_;
+
+  DISALLOW_COPY_AND_ASSIGN(ModuleCompilerBindings);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_EXTENSIONS_MODULE_COMPILER_BINDINGS_H_
@@ -0,0 +1,262 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/v8_worker_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "base/bind.h"
+#include "brave/common/workers/v8_worker_thread.h"
+#include "brave/common/workers/worker_bindings.h"
+#include "brave/common/workers/worker_message.h"
+#include "content/public/browser/browser_thread.h"
+#include "native_mate/dictionary.h"
+
+using content::BrowserThread;
+
+namespace brave {
+
+namespace {
+
+const size_t kDefaultMaxWorkers = 4;
+const int kDefaultIdleTimeoutSeconds = 60;
+
+// Only accessed on the UI thread.
+V8WorkerPool* g_worker_pool = nullptr;
+
+}  // namespace
+
+V8WorkerPool::Job::Job() : id(0) {}
+
+V8WorkerPool::Job::~Job() {}
+
+V8WorkerPool::WorkerState::WorkerState()
+    : worker(nullptr), job_id(0), jobs_run(0) {}
+
+V8WorkerPool::WorkerState::~WorkerState() {}
+
+// static
+V8WorkerPool* V8WorkerPool::GetInstance(atom::api::App* app) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (!g_worker_pool)
+    g_worker_pool = new V8WorkerPool(app);
+  return g_worker_pool;
+}
+
+V8WorkerPool::V8WorkerPool(atom::api::App* app)
+    : app_(app),
+      max_workers_(kDefaultMaxWorkers),
+      idle_timeout_(base::TimeDelta::FromSeconds(kDefaultIdleTimeoutSeconds)),
+      next_job_id_(1) {
+}
+
+V8WorkerPool::~V8WorkerPool() {
+}
+
+void V8WorkerPool::SetOptions(size_t max_workers,
+                              base::TimeDelta idle_timeout) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  max_workers_ = std::max<size_t>(max_workers, 1);
+  idle_timeout_ = idle_timeout;
+  RunPendingJobs();
+}
+
+int V8WorkerPool::StartJob(const std::string& module_name) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  std::unique_ptr<Job> job(new Job);
+  job->id = next_job_id_++;
+  job->module_name = module_name;
+  int job_id = job->id;
+
+  queue_.push_back(std::move(job));
+  RunPendingJobs();
+  return job_id;
+}
+
+void V8WorkerPool::StopJob(int job_id) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+    if ((*it)->id == job_id) {
+      queue_.erase(it);
+      return;
+    }
+  }
+
+  WorkerState* state = FindWorkerForJob(job_id);
+  if (state) {
+    state->worker->task_runner()->PostTask(FROM_HERE,
+        base::Bind(&V8WorkerThread::FinishJob,
+                   base::Unretained(state->worker), job_id));
+  }
+}
+
+bool V8WorkerPool::PostMessage(v8::Isolate* isolate, int job_id,
+                               v8::Local<v8::Value> message,
+                               v8::Local<v8::Value> transfer_list,
+                               std::string* error) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  // Look up the job first so nothing gets transferred to a job that is gone.
+  WorkerState* state = FindWorkerForJob(job_id);
+  Job* queued_job = nullptr;
+  if (!state) {
+    for (const auto& job : queue_) {
+      if (job->id == job_id) {
+        queued_job = job.get();
+        break;
+      }
+    }
+    if (!queued_job) {
+      *error = "Unknown pooled worker";
+      return false;
+    }
+  }
+
+  std::unique_ptr<WorkerMessage> worker_message(new WorkerMessage);
+  if (!worker_message->Serialize(isolate, isolate->GetCurrentContext(),
+                                 message, transfer_list, error))
+    return false;
+
+  if (state) {
+    WorkerBindings::OnMessage(state->worker, job_id,
+                              std::move(worker_message));
+  } else {
+    queued_job->pending_messages.push_back(std::move(worker_message));
+  }
+  return true;
+}
+
+v8::Local<v8::Value> V8WorkerPool::GetStats(v8::Isolate* isolate) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  base::TimeTicks now = base::TimeTicks::Now();
+  std::vector<v8::Local<v8::Value>> workers;
+  for (const auto& state : workers_) {
+    base::TimeDelta busy_time = state->busy_time;
+    if (state->job_id)
+      busy_time += now - state->busy_since;
+
+    mate::Dictionary worker = mate::Dictionary::CreateEmpty(isolate);
+    worker.Set("id", static_cast<int>(state->worker->GetThreadId()));
+    worker.Set("jobId", state->job_id);
+    worker.Set("busy", state->job_id != 0);
+    worker.Set("jobsRun", state->jobs_run);
+    worker.Set("busyTime", busy_time.InMillisecondsF());
+    workers.push_back(worker.GetHandle());
+  }
+
+  mate::Dictionary dict = mate::Dictionary::CreateEmpty(isolate);
+  dict.Set("maxWorkers", static_cast<uint32_t>(max_workers_));
+  dict.Set("idleTimeout", idle_timeout_.InMillisecondsF());
+  dict.Set("queueDepth", static_cast<uint32_t>(queue_.size()));
+  dict.Set("workers", workers);
+  return dict.GetHandle();
+}
+
+void V8WorkerPool::OnJobFinished(V8WorkerThread* worker) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  WorkerState* state = FindWorker(worker);
+  if (!state)
+    return;
+
+  state->busy_time += base::TimeTicks::Now() - state->busy_since;
+  state->job_id = 0;
+
+  RunPendingJobs();
+
+  if (!state->job_id && !idle_timeout_.is_zero()) {
+    state->idle_timer.Start(FROM_HERE, idle_timeout_,
+        base::Bind(&V8WorkerPool::OnIdleTimeout, base::Unretained(this),
+                   base::Unretained(worker)));
+  }
+}
+
+void V8WorkerPool::OnWorkerDestroyed(V8WorkerThread* worker) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  for (auto it = workers_.begin(); it != workers_.end(); ++it) {
+    if ((*it)->worker == worker) {
+      workers_.erase(it);
+      break;
+    }
+  }
+  RunPendingJobs();
+}
+
+V8WorkerPool::WorkerState* V8WorkerPool::GetIdleWorker() {
+  for (const auto& state : workers_) {
+    if (!state->job_id)
+      return state.get();
+  }
+
+  if (workers_.size() >= max_workers_)
+    return nullptr;
+
+  std::unique_ptr<WorkerState> state(new WorkerState);
+  state->worker = new V8WorkerThread("pool_worker", std::string(), app_, this);
+  if (!state->worker->Start()) {
+    delete state->worker;
+    return nullptr;
+  }
+  workers_.push_back(std::move(state));
+  return workers_.back().get();
+}
+
+V8WorkerPool::WorkerState* V8WorkerPool::FindWorker(V8WorkerThread* worker) {
+  for (const auto& state : workers_) {
+    if (state->worker == worker)
+      return state.get();
+  }
+  return nullptr;
+}
+
+V8WorkerPool::WorkerState* V8WorkerPool::FindWorkerForJob(int job_id) {
+  for (const auto& state : workers_) {
+    if (state->job_id == job_id)
+      return state.get();
+  }
+  return nullptr;
+}
+
+void V8WorkerPool::RunJob(WorkerState* state, std::unique_ptr<Job> job) {
+  state->idle_timer.Stop();
+  state->job_id = job->id;
+  state->jobs_run++;
+  state->busy_since = base::TimeTicks::Now();
+  state->worker->StartModule(job->module_name, job->id);
+
+  for (auto& message : job->pending_messages)
+    WorkerBindings::OnMessage(state->worker, job->id, std::move(message));
+}
+
+void V8WorkerPool::RunPendingJobs() {
+  while (!queue_.empty()) {
+    WorkerState* state = GetIdleWorker();
+    if (!state)
+      return;
+
+    std::unique_ptr<Job> job = std::move(queue_.front());
+    queue_.pop_front();
+    RunJob(state, std::move(job));
+  }
+}
+
+void V8WorkerPool::OnIdleTimeout(V8WorkerThread* worker) {
+  WorkerState* state = FindWorker(worker);
+  if (!state || state->job_id)
+    return;
+
+  ShutdownWorker(worker);
+  for (auto it = workers_.begin(); it != workers_.end(); ++it) {
+    if ((*it)->worker == worker) {
+      workers_.erase(it);
+      break;
+    }
+  }
+}
+
+void V8WorkerPool::ShutdownWorker(V8WorkerThread* worker) {
+  worker->task_runner()->PostTask(FROM_HERE,
+      base::Bind(&V8WorkerThread::Shutdown));
+}
+
+}  // namespace brave
@@ -0,0 +1,107 @@
+// Copyright 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_V8_WORKER_POOL_H_
+#define BRAVE_COMMON_WORKERS_V8_WORKER_POOL_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "base/timer/timer.h"
+#include "v8/include/v8.h"
+
+namespace atom {
+namespace api {
+class App;
+}
+}
+
+namespace brave {
+
+class V8WorkerThread;
+class WorkerMessage;
+
+// Runs worker modules as jobs on a bounded set of V8WorkerThreads. Threads
+// are kept alive between jobs with a warm environment and shut down after
+// being idle for |idle_timeout_|. Lives on the UI thread.
+class V8WorkerPool {
+ public:
+  // The pool is never destroyed, workers may report back to it until the
+  // very end.
+  static V8WorkerPool* GetInstance(atom::api::App* app);
+
+  void SetOptions(size_t max_workers, base::TimeDelta idle_timeout);
+  size_t max_workers() const { return max_workers_; }
+  base::TimeDelta idle_timeout() const { return idle_timeout_; }
+
+  // Queues |module_name| and returns the job id used in "worker-pool-*"
+  // events.
+  int StartJob(const std::string& module_name);
+  void StopJob(int job_id);
+  // Messages for queued jobs are kept until the job gets a worker.
+  bool PostMessage(v8::Isolate* isolate, int job_id,
+                   v8::Local<v8::Value> message,
+                   v8::Local<v8::Value> transfer_list,
+                   std::string* error);
+
+  // Queue depth and per worker busy time.
+  v8::Local<v8::Value> GetStats(v8::Isolate* isolate);
+
+  void OnJobFinished(V8WorkerThread* worker);
+  void OnWorkerDestroyed(V8WorkerThread* worker);
+
+ private:
+  struct Job {
+    Job();
+    ~Job();
+
+    int id;
+    std::string module_name;
+    // Messages posted before the job got a worker.
+    std::vector<std::unique_ptr<WorkerMessage>> pending_messages;
+  };
+
+  struct WorkerState {
+    WorkerState();
+    ~WorkerState();
+
+    V8WorkerThread* worker;
+    // The running job, or 0 if the worker is idle.
+    int job_id;
+    int jobs_run;
+    base::TimeTicks busy_since;
+    base::TimeDelta busy_time;
+    base::OneShotTimer idle_timer;
+  };
+
+  explicit V8WorkerPool(atom::api::App* app);
+  ~V8WorkerPool();
+
+  WorkerState* GetIdleWorker();
+  WorkerState* FindWorker(V8WorkerThread* worker);
+  WorkerState* FindWorkerForJob(int job_id);
+  void RunJob(WorkerState* state, std::unique_ptr<Job> job);
+  void RunPendingJobs();
+  void OnIdleTimeout(V8WorkerThread* worker);
+  void ShutdownWorker(V8WorkerThread* worker);
+
+  atom::api::App* app_;
+  size_t max_workers_;
+  base::TimeDelta idle_timeout_;
+  int next_job_id_;
+
+  std::vector<std::unique_ptr<WorkerState>> workers_;
+  std::deque<std::unique_ptr<Job>> queue_;
+
+  DISALLOW_COPY_AND_ASSIGN(V8WorkerPool);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_V8_WORKER_POOL_H_
@@ -7,8 +7,11 @@
 #include "atom/browser/api/atom_api_app.h"
 #include "atom/browser/javascript_environment.h"
 #include "base/lazy_instance.h"
+#include "base/metrics/histogram_macros.h"
 #include "base/run_loop.h"
+#include "base/threading/platform_thread.h"
 #include "base/threading/thread_local.h"
+#include "brave/common/workers/v8_worker_pool.h"
 #include "brave/common/workers/worker_bindings.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/renderer/worker_thread_registry.h"
@@ -23,19 +26,66 @@ namespace {
 base::LazyInstance<base::ThreadLocalPointer<V8WorkerThread>>::Leaky worker =
       LAZY_INSTANCE_INITIALIZER;
 
-void NotifyStart(atom::api::App* app, int worker_id) {
-  app->Emit("worker-start", worker_id);
+const char kCommonJSModule[] = "muon/module_system/commonjs";
+
+// Only accessed on the UI thread.
+atom::api::App* g_warm_worker_app = nullptr;
+V8WorkerThread* g_warm_worker = nullptr;
+
+void PrepareWarmWorker() {
+  if (!g_warm_worker_app || g_warm_worker)
+    return;
+
+  auto warm_worker = new V8WorkerThread("warm_worker", std::string(),
+                                        g_warm_worker_app);
+  if (warm_worker->Start())
+    g_warm_worker = warm_worker;
+  else
+    delete warm_worker;
+}
+
+enum StartType {
+  COLD_START,
+  WARM_START,
+  POOLED_START,
+};
+
+void NotifyStart(atom::api::App* app, const std::string& event, int worker_id,
+                 StartType start_type, base::TimeTicks start_time) {
+  base::TimeDelta start_duration = base::TimeTicks::Now() - start_time;
+  switch (start_type) {
+    case COLD_START:
+      UMA_HISTOGRAM_TIMES("Brave.Worker.StartTime.Cold", start_duration);
+      break;
+    case WARM_START:
+      UMA_HISTOGRAM_TIMES("Brave.Worker.StartTime.Warm", start_duration);
+      break;
+    case POOLED_START:
+      UMA_HISTOGRAM_TIMES("Brave.Worker.StartTime.Pooled", start_duration);
+      break;
+  }
+  app->Emit(event, worker_id);
+}
+
+void NotifyStop(atom::api::App* app, const std::string& event,
+                int worker_id) {
+  app->Emit(event, worker_id);
 }
 
-void NotifyStop(atom::api::App* app, int worker_id) {
-  app->Emit("worker-stop", worker_id);
+void NotifyError(atom::api::App* app, const std::string& event, int worker_id,
+                 std::string error) {
+  app->Emit(event, worker_id, error);
 }
 
-void NotifyError(atom::api::App* app, int worker_id, std::string error) {
-  app->Emit("worker-onerror", worker_id, error);
+void NotifyJobFinished(V8WorkerPool* pool, V8WorkerThread* worker) {
+  pool->OnJobFinished(worker);
 }
 
 void Kill(V8WorkerThread* worker) {
+  if (worker == g_warm_worker)
+    g_warm_worker = nullptr;
+  if (worker->pool())
+    worker->pool()->OnWorkerDestroyed(worker);
   delete worker;
 }
 
@@ -43,10 +93,15 @@ void Kill(V8WorkerThread* worker) {
 
 V8WorkerThread::V8WorkerThread(const std::string& name,
                               const std::string& module_name,
-                              atom::api::App* app) :
+                              atom::api::App* app,
+                              V8WorkerPool* pool) :
     base::Thread(name),
     module_name_(module_name),
-    app_(app) {
+    warm_up_(module_name.empty()),
+    app_(app),
+    pool_(pool),
+    job_id_(0),
+    start_time_(base::TimeTicks::Now()) {
 }
 
 V8WorkerThread::~V8WorkerThread() {
@@ -66,13 +121,88 @@ void V8WorkerThread::Shutdown() {
 
   worker.Get().Set(nullptr);
 
+  // Warm workers that never got a module were never announced.
+  if (!instance->module_name().empty()) {
+    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+        base::Bind(&NotifyStop,
+                    base::Unretained(instance->app()),
+                    instance->event_name("stop"),
+                    instance->worker_id()));
+  }
+
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+                          base::Bind(&Kill, base::Unretained(instance)));
+}
+
+// static
+void V8WorkerThread::SetWarmWorkerEnabled(atom::api::App* app, bool enabled) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  g_warm_worker_app = enabled ? app : nullptr;
+  if (enabled) {
+    PrepareWarmWorker();
+  } else if (g_warm_worker) {
+    V8WorkerThread* warm_worker = g_warm_worker;
+    g_warm_worker = nullptr;
+    warm_worker->task_runner()->PostTask(FROM_HERE,
+        base::Bind(&V8WorkerThread::Shutdown));
+  }
+}
+
+// static
+V8WorkerThread* V8WorkerThread::TakeWarmWorker() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  V8WorkerThread* warm_worker = g_warm_worker;
+  g_warm_worker = nullptr;
+  PrepareWarmWorker();
+  return warm_worker;
+}
+
+void V8WorkerThread::StartModule(const std::string& module_name,
+                                 int job_id,
+                                 const std::string& thread_name) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  // The task is run after WarmUp(), so the module is loaded into a ready
+  // environment. The module is only assigned on the worker thread, which
+  // reads it while the thread starts.
+  task_runner()->PostTask(FROM_HERE,
+      base::Bind(&V8WorkerThread::AssignModule, base::Unretained(this),
+                 module_name, job_id, thread_name, base::TimeTicks::Now()));
+}
+
+void V8WorkerThread::FinishJob(int job_id) {
+  DCHECK_EQ(this, current());
+  DCHECK(pool_);
+  // Both close() and stopJob() may ask to finish the same job, and the
+  // second request can arrive once the worker runs another job.
+  if (module_name_.empty() || job_id != job_id_)
+    return;
+
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
       base::Bind(&NotifyStop,
-                  base::Unretained(instance->app()),
-                  instance->GetThreadId()));
+                  base::Unretained(app()),
+                  event_name("stop"),
+                  worker_id()));
+
+  module_name_.clear();
+  job_id_ = 0;
+
+  // Every module gets a fresh context, the thread and the isolate are
+  // reused.
+  env()->ResetContext();
+  WarmUp();
 
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-                          base::Bind(&Kill, base::Unretained(instance)));
+      base::Bind(&NotifyJobFinished,
+                  base::Unretained(pool_),
+                  base::Unretained(this)));
+}
+
+int V8WorkerThread::worker_id() const {
+  return pool_ ? job_id_ : static_cast<int>(GetThreadId());
+}
+
+std::string V8WorkerThread::event_name(const std::string& event) const {
+  return (pool_ ? "worker-pool-" : "worker-") + event;
 }
 
 void V8WorkerThread::Init() {
@@ -80,10 +210,6 @@ void V8WorkerThread::Init() {
 
   js_env_.reset(new atom::JavascriptEnvironment());
 
-  env()->module_system()->RegisterNativeHandler(
-      "worker", std::unique_ptr<extensions::NativeHandler>(
-          new WorkerBindings(env()->script_context(), this)));
-
   memory_pressure_listener_.reset(new base::MemoryPressureListener(
       base::Bind(&V8WorkerThread::OnMemoryPressure,
         base::Unretained(this))));
@@ -93,12 +219,52 @@ void V8WorkerThread::Run(base::RunLoop* run_loop) {
   base::ThreadRestrictions::SetIOAllowed(true);
   content::WorkerThreadRegistry::Instance()->DidStartCurrentWorkerThread();
   env()->OnMessageLoopCreated();
+  if (warm_up_)
+    WarmUp();
+  else
+    InitModule();
+  Thread::Run(run_loop);
+}
+
+void V8WorkerThread::WarmUp() {
+  // Load the commonjs loader ahead of time, every module requires it.
+  ModuleSystem::NativesEnabledScope natives_enabled(env()->module_system());
+  env()->module_system()->Require(kCommonJSModule);
+}
+
+void V8WorkerThread::AssignModule(const std::string& module_name,
+                                  int job_id,
+                                  const std::string& thread_name,
+                                  base::TimeTicks start_time) {
+  DCHECK_EQ(this, current());
+  DCHECK(module_name_.empty());
+  // The thread was started under a placeholder name.
+  if (!thread_name.empty())
+    base::PlatformThread::SetName(thread_name);
+  module_name_ = module_name;
+  job_id_ = job_id;
+  start_time_ = start_time;
+  InitModule();
+}
+
+void V8WorkerThread::InitModule() {
+  env()->module_system()->RegisterNativeHandler(
+      "worker", std::unique_ptr<extensions::NativeHandler>(
+          new WorkerBindings(env()->script_context(), this)));
+
   LoadModule();
+  StartType start_type = COLD_START;
+  if (pool_)
+    start_type = POOLED_START;
+  else if (warm_up_)
+    start_type = WARM_START;
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
       base::Bind(&NotifyStart,
                   base::Unretained(app()),
-                  GetThreadId()));
-  Thread::Run(run_loop);
+                  event_name("start"),
+                  worker_id(),
+                  start_type,
+                  start_time_));
 }
 
 // Called just after the message loop ends
@@ -120,9 +286,16 @@ void V8WorkerThread::LoadModule() {
     BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
         base::Bind(&NotifyError,
                     base::Unretained(app()),
-                    GetThreadId(),
+                    event_name("onerror"),
+                    worker_id(),
                     "No source for require(" + module_name_ + ")"));
-    base::RunLoop::QuitCurrentDeprecated();
+    if (pool_) {
+      task_runner()->PostTask(FROM_HERE,
+          base::Bind(&V8WorkerThread::FinishJob, base::Unretained(this),
+                     job_id_));
+    } else {
+      base::RunLoop::QuitCurrentDeprecated();
+    }
     return;
   }
 
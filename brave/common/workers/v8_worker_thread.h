@@ -10,6 +10,7 @@
 
 #include "base/memory/memory_pressure_listener.h"
 #include "base/threading/thread.h"
+#include "base/time/time.h"
 
 namespace atom {
 class JavascriptEnvironment;
@@ -20,15 +21,36 @@ class App;
 
 namespace brave {
 
+class V8WorkerPool;
+
 class V8WorkerThread : public base::Thread {
  public:
   explicit V8WorkerThread(const std::string& name,
-      const std::string& module_name, atom::api::App* app);
+      const std::string& module_name, atom::api::App* app,
+      V8WorkerPool* pool = nullptr);
   ~V8WorkerThread() override;
 
   static V8WorkerThread* current();
   static void Shutdown();
 
+  // Warm workers have their environment and the commonjs loader ready before
+  // any module is assigned, so starting a worker only has to load the module.
+  // All of these must be called on the UI thread.
+  static void SetWarmWorkerEnabled(atom::api::App* app, bool enabled);
+  // Returns the warm worker, or nullptr if there is none, and prepares the
+  // next one.
+  static V8WorkerThread* TakeWarmWorker();
+  // Loads |module_name| in a warm worker, |job_id| identifies the module in
+  // the events of pooled workers. The thread is renamed to |thread_name|
+  // unless it is empty.
+  void StartModule(const std::string& module_name,
+                   int job_id = 0,
+                   const std::string& thread_name = std::string());
+  // Ends the module of a pooled worker and prepares a fresh context for the
+  // next one, must be called on the worker thread. Requests for a job that
+  // already finished are ignored.
+  void FinishJob(int job_id);
+
   void Init() override;
   void Run(base::RunLoop* run_loop) override;
   void CleanUp() override;
@@ -36,14 +58,37 @@ class V8WorkerThread : public base::Thread {
   atom::api::App* app() const { return app_; }
   atom::JavascriptEnvironment* env() const { return js_env_.get(); }
   const std::string& module_name() const { return module_name_; }
+  V8WorkerPool* pool() const { return pool_; }
+
+  // The id and prefix of the events about the current module, pooled workers
+  // report their job id in "worker-pool-*" events. Only valid on the worker
+  // thread.
+  int job_id() const { return job_id_; }
+  int worker_id() const;
+  std::string event_name(const std::string& event) const;
 
  private:
+  void WarmUp();
+  // Sets the module of a warm worker and loads it.
+  void AssignModule(const std::string& module_name,
+                    int job_id,
+                    const std::string& thread_name,
+                    base::TimeTicks start_time);
+  void InitModule();
   void LoadModule();
   void OnMemoryPressure(
     base::MemoryPressureListener::MemoryPressureLevel memory_pressure_level);
 
-  const std::string module_name_;
+  // Empty until a module is assigned to a warm worker, only accessed on the
+  // worker thread once it is started.
+  std::string module_name_;
+  // Whether the worker was started without a module, fixed at construction
+  // since |module_name_| may be assigned while the thread starts.
+  const bool warm_up_;
   atom::api::App* app_;
+  V8WorkerPool* pool_;
+  int job_id_;
+  base::TimeTicks start_time_;
   std::unique_ptr<atom::JavascriptEnvironment> js_env_;
   std::unique_ptr<base::MemoryPressureListener> memory_pressure_listener_;
 };
@@ -9,6 +9,7 @@
 
 #include "atom/browser/api/atom_api_app.h"
 #include "brave/common/workers/v8_worker_thread.h"
+#include "brave/common/workers/worker_message.h"
 #include "content/public/browser/browser_thread.h"
 #include "content/renderer/worker_thread_registry.h"
 #include "extensions/renderer/script_context.h"
@@ -31,16 +32,12 @@ bool SetReadOnlyProperty(v8::Local<v8::Context> context,
       static_cast<v8::PropertyAttribute>(v8::ReadOnly)));
 }
 
-void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
+void OnMessageInternal(std::unique_ptr<WorkerMessage> worker_message) {
   v8::Isolate* isolate = v8::Isolate::GetCurrent();
   v8::Local<v8::Context> context = isolate->GetCurrentContext();
 
-  v8::ValueDeserializer deserializer(
-      isolate, buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(context).FromMaybe(false)) {
-    v8::Local<v8::Value> message =
-        deserializer.ReadValue(context).ToLocalChecked();
+  v8::Local<v8::Value> message;
+  if (worker_message->Deserialize(isolate, context).ToLocal(&message)) {
     v8::Local<v8::Object> global = context->Global();
     v8::Local<v8::Value> onmessage =
         global->Get(context, v8::String::NewFromUtf8(isolate, "onmessage",
@@ -54,7 +51,40 @@ void OnMessageInternal(const std::pair<uint8_t*, size_t>& buf) {
       (void)onmessage_fun->Call(context, global, 1, argv);
     }
   }
-  free(buf.first);
+}
+
+void OnJobMessage(V8WorkerThread* worker,
+                  int job_id,
+                  std::unique_ptr<WorkerMessage> worker_message) {
+  if (worker->job_id() != job_id)
+    return;
+
+  OnMessageInternal(std::move(worker_message));
+}
+
+// The UI thread side of the bindings only gets the app and the worker id, the
+// bindings themselves are destroyed on the worker thread whenever its
+// environment goes away.
+void PostMessageOnUIThread(atom::api::App* app,
+                           const std::string& event_prefix,
+                           int worker_id,
+                           std::unique_ptr<WorkerMessage> message) {
+  v8::Local<v8::Value> val;
+  if (message->Deserialize(app->isolate(),
+          app->isolate()->GetCurrentContext()).ToLocal(&val)) {
+    app->Emit(event_prefix + "post-message", worker_id, val);
+  } else {
+    app->Emit(event_prefix + "onerror", worker_id,
+        "`postMessage` could not deserialize message buffer");
+  }
+}
+
+void OnErrorOnUIThread(atom::api::App* app,
+                       const std::string& event,
+                       int worker_id,
+                       const std::string& message,
+                       const std::string& stack) {
+  app->Emit(event, worker_id, message, stack);
 }
 
 }  // namespace
@@ -136,12 +166,6 @@ WorkerBindings::WorkerBindings(extensions::ScriptContext* context,
 WorkerBindings::~WorkerBindings() {
 }
 
-void WorkerBindings::OnErrorOnUIThread(const std::string& message,
-                                        const std::string& stack) {
-  worker_->app()->Emit(
-      "worker-onerror", worker_->GetThreadId(), message, stack);
-}
-
 void WorkerBindings::OnError(
     const v8::FunctionCallbackInfo<v8::Value>& args) {
 
@@ -166,36 +190,29 @@ void WorkerBindings::OnError(
   }
 
   BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-      base::Bind(&WorkerBindings::OnErrorOnUIThread,
-                  weak_ptr_factory_.GetWeakPtr(),
+      base::Bind(&OnErrorOnUIThread,
+                  base::Unretained(worker_->app()),
+                  worker_->event_name("onerror"),
+                  worker_->worker_id(),
                   std::move(message),
                   std::move(stack_trace)));
 }
 
 void WorkerBindings::Close(
     const v8::FunctionCallbackInfo<v8::Value>& args) {
+  // Pooled workers only end their module and stay around for the next one.
+  if (worker_->pool()) {
+    worker_->task_runner()->PostTask(FROM_HERE,
+        base::Bind(&V8WorkerThread::FinishJob, base::Unretained(worker_),
+                   worker_->job_id()));
+    return;
+  }
+
   content::WorkerThreadRegistry::Instance()->
       GetTaskRunnerFor(worker_->GetThreadId())->PostTask(
           FROM_HERE, base::Bind(&brave::V8WorkerThread::Shutdown));
 }
 
-void WorkerBindings::PostMessageOnUIThread(
-    const std::pair<uint8_t*, size_t>& buf) {
-  v8::ValueDeserializer deserializer(
-      worker_->app()->isolate(), buf.first, buf.second);
-  deserializer.SetSupportsLegacyWireFormat(true);
-  if (deserializer.ReadHeader(
-      worker_->app()->isolate()->GetCurrentContext()).FromMaybe(false)) {
-    v8::Local<v8::Value> val = deserializer.ReadValue(
-        worker_->app()->isolate()->GetCurrentContext()).ToLocalChecked();
-    worker_->app()->Emit("worker-post-message", worker_->GetThreadId(), val);
-  } else {
-    worker_->app()->Emit("worker-onerror", worker_->GetThreadId(),
-        "`postMessage` could not deserialize message buffer");
-  }
-  free(buf.first);
-}
-
 void WorkerBindings::PostMessage(
     const v8::FunctionCallbackInfo<v8::Value>& args) {
   if (args.Length() < 1) {
@@ -204,46 +221,43 @@ void WorkerBindings::PostMessage(
     return;
   }
 
-  if (args.Length() > 1) {
+  v8::Local<v8::Value> transfer_list;
+  if (args.Length() > 1)
+    transfer_list = args[1];
+
+  std::unique_ptr<WorkerMessage> message(new WorkerMessage);
+  std::string error;
+  if (!message->Serialize(context()->isolate(), context()->v8_context(),
+                          args[0], transfer_list, &error)) {
     context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`transferList` is not supported yet"));
+        context()->isolate(), error.c_str()));
     return;
   }
 
-  v8::ValueSerializer serializer(context()->isolate());
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      context()->v8_context(), args[0]).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
+      base::Bind(&PostMessageOnUIThread,
+                  base::Unretained(worker_->app()),
+                  worker_->event_name(""),
+                  worker_->worker_id(),
+                  base::Passed(&message)));
+}
 
-    BrowserThread::PostTask(BrowserThread::UI, FROM_HERE,
-        base::Bind(&WorkerBindings::PostMessageOnUIThread,
-                    weak_ptr_factory_.GetWeakPtr(),
-                    std::move(buffer)));
-  } else {
-    context()->isolate()->ThrowException(v8::String::NewFromUtf8(
-        context()->isolate(), "`postMessage` could not serialize message"));
-  }
+// static
+void WorkerBindings::OnMessage(base::PlatformThreadId thread_id,
+                               std::unique_ptr<WorkerMessage> message) {
+  base::TaskRunner* task_runner =
+      content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
+  task_runner->PostTask(FROM_HERE,
+      base::Bind(&OnMessageInternal, base::Passed(&message)));
 }
 
 // static
-bool WorkerBindings::OnMessage(v8::Isolate* isolate,
-                                base::PlatformThreadId thread_id,
-                                v8::Local<v8::Value> message) {
-  v8::ValueSerializer serializer(isolate);
-  serializer.WriteHeader();
-  if (serializer.WriteValue(
-      isolate->GetCurrentContext(), message).FromMaybe(false)) {
-    std::pair<uint8_t*, size_t> buffer = serializer.Release();
-
-    base::TaskRunner* task_runner =
-        content::WorkerThreadRegistry::Instance()->GetTaskRunnerFor(thread_id);
-    task_runner->PostTask(FROM_HERE,
-        base::Bind(&OnMessageInternal,
-        std::move(buffer)));
-    return true;
-  }
-  return false;
+void WorkerBindings::OnMessage(V8WorkerThread* worker,
+                               int job_id,
+                               std::unique_ptr<WorkerMessage> message) {
+  worker->task_runner()->PostTask(FROM_HERE,
+      base::Bind(&OnJobMessage, base::Unretained(worker), job_id,
+                 base::Passed(&message)));
 }
 
 }  // namespace brave
@@ -5,6 +5,7 @@
 #ifndef BRAVE_COMMON_WORKERS_WORKER_BINDINGS_H_
 #define BRAVE_COMMON_WORKERS_WORKER_BINDINGS_H_
 
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -17,20 +18,26 @@
 namespace brave {
 
 class V8WorkerThread;
+class WorkerMessage;
 
 class WorkerBindings : public extensions::ObjectBackedNativeHandler {
  public:
   WorkerBindings(extensions::ScriptContext* context, V8WorkerThread* worker);
   ~WorkerBindings() override;
-  static bool OnMessage(v8::Isolate* isolate,
-                        base::PlatformThreadId thread_id,
-                        v8::Local<v8::Value> message);
+  // Delivers |message| to the onmessage handler of the worker running on
+  // |thread_id|.
+  static void OnMessage(base::PlatformThreadId thread_id,
+                        std::unique_ptr<WorkerMessage> message);
+  // Delivers |message| to the pooled |worker| through its own task runner so
+  // it is queued behind the module start. The message is dropped if |job_id|
+  // is no longer the job running on |worker| by the time it is delivered.
+  static void OnMessage(V8WorkerThread* worker,
+                        int job_id,
+                        std::unique_ptr<WorkerMessage> message);
 
  private:
   void Close(const v8::FunctionCallbackInfo<v8::Value>& args);
-  void PostMessageOnUIThread(const std::pair<uint8_t*, size_t>& buffer);
   void PostMessage(const v8::FunctionCallbackInfo<v8::Value>& args);
-  void OnErrorOnUIThread(const std::string& message, const std::string& stack);
   void OnError(const v8::FunctionCallbackInfo<v8::Value>& args);
 
   V8WorkerThread* worker_;
@@ -0,0 +1,107 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "brave/common/workers/worker_message.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+
+namespace brave {
+
+WorkerMessage::WorkerMessage() : data_(nullptr), size_(0) {
+}
+
+WorkerMessage::~WorkerMessage() {
+  free(data_);
+  // Buffers that were never handed to an isolate.
+  for (const auto& contents : array_buffers_)
+    free(contents.data);
+}
+
+bool WorkerMessage::Serialize(v8::Isolate* isolate,
+                              v8::Local<v8::Context> context,
+                              v8::Local<v8::Value> value,
+                              v8::Local<v8::Value> transfer_list,
+                              std::string* error) {
+  std::vector<v8::Local<v8::ArrayBuffer>> array_buffers;
+  if (!transfer_list.IsEmpty() && !transfer_list->IsUndefined()) {
+    if (!transfer_list->IsArray()) {
+      *error = "`transferList` must be an array";
+      return false;
+    }
+
+    v8::Local<v8::Array> list = transfer_list.As<v8::Array>();
+    for (uint32_t i = 0; i < list->Length(); ++i) {
+      v8::Local<v8::Value> item;
+      if (!list->Get(context, i).ToLocal(&item) || !item->IsArrayBuffer()) {
+        *error = "`transferList` can only contain ArrayBuffers";
+        return false;
+      }
+
+      v8::Local<v8::ArrayBuffer> array_buffer = item.As<v8::ArrayBuffer>();
+      if (!array_buffer->IsNeuterable() ||
+          std::find(array_buffers.begin(), array_buffers.end(),
+                    array_buffer) != array_buffers.end()) {
+        *error = "`transferList` contains an ArrayBuffer that can't be moved";
+        return false;
+      }
+      array_buffers.push_back(array_buffer);
+    }
+  }
+
+  v8::ValueSerializer serializer(isolate);
+  serializer.WriteHeader();
+  for (size_t i = 0; i < array_buffers.size(); ++i)
+    serializer.TransferArrayBuffer(static_cast<uint32_t>(i), array_buffers[i]);
+
+  if (!serializer.WriteValue(context, value).FromMaybe(false)) {
+    *error = "`postMessage` could not serialize message";
+    return false;
+  }
+
+  std::pair<uint8_t*, size_t> buffer = serializer.Release();
+  data_ = buffer.first;
+  size_ = buffer.second;
+
+  for (const auto& array_buffer : array_buffers) {
+    ArrayBufferContents contents;
+    if (array_buffer->IsExternal()) {
+      // The memory belongs to someone else, so it has to be copied.
+      v8::ArrayBuffer::Contents external = array_buffer->GetContents();
+      contents.length = external.ByteLength();
+      contents.data = malloc(std::max<size_t>(contents.length, 1));
+      memcpy(contents.data, external.Data(), contents.length);
+    } else {
+      v8::ArrayBuffer::Contents externalized = array_buffer->Externalize();
+      contents.data = externalized.Data();
+      contents.length = externalized.ByteLength();
+    }
+    array_buffer->Neuter();
+    array_buffers_.push_back(contents);
+  }
+  return true;
+}
+
+v8::MaybeLocal<v8::Value> WorkerMessage::Deserialize(
+    v8::Isolate* isolate,
+    v8::Local<v8::Context> context) {
+  v8::ValueDeserializer deserializer(isolate, data_, size_);
+  deserializer.SetSupportsLegacyWireFormat(true);
+
+  for (size_t i = 0; i < array_buffers_.size(); ++i) {
+    deserializer.TransferArrayBuffer(static_cast<uint32_t>(i),
+        v8::ArrayBuffer::New(isolate, array_buffers_[i].data,
+                             array_buffers_[i].length,
+                             v8::ArrayBufferCreationMode::kInternalized));
+  }
+  array_buffers_.clear();
+
+  if (!deserializer.ReadHeader(context).FromMaybe(false))
+    return v8::MaybeLocal<v8::Value>();
+  return deserializer.ReadValue(context);
+}
+
+}  // namespace brave
@@ -0,0 +1,53 @@
+// Copyright (c) 2017 The Brave Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+#define BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/macros.h"
+#include "v8/include/v8.h"
+
+namespace brave {
+
+// A message serialized in one isolate to be deserialized in another one.
+// ArrayBuffers in the transfer list are moved into the message instead of
+// being copied, and their backing stores are handed to the receiving isolate.
+// Both isolates must use gin's ArrayBufferAllocator.
+class WorkerMessage {
+ public:
+  WorkerMessage();
+  ~WorkerMessage();
+
+  // Serializes |value|, |transfer_list| is either empty, undefined or an
+  // array of ArrayBuffers which are neutered on success.
+  bool Serialize(v8::Isolate* isolate,
+                 v8::Local<v8::Context> context,
+                 v8::Local<v8::Value> value,
+                 v8::Local<v8::Value> transfer_list,
+                 std::string* error);
+
+  // Can only be called once, the transferred ArrayBuffers are owned by
+  // |isolate| afterwards.
+  v8::MaybeLocal<v8::Value> Deserialize(v8::Isolate* isolate,
+                                        v8::Local<v8::Context> context);
+
+ private:
+  struct ArrayBufferContents {
+    void* data;
+    size_t length;
+  };
+
+  uint8_t* data_;
+  size_t size_;
+  std::vector<ArrayBufferContents> array_buffers_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerMessage);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_COMMON_WORKERS_WORKER_MESSAGE_H_
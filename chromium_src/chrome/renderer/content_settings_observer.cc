@@ -244,7 +244,7 @@ bool ContentSettingsObserver::AllowDatabase(const WebString& name,
   bool allow = true;
   GURL secondary_url(
       blink::WebStringToGURL(frame->GetSecurityOrigin().ToString()));
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
           ContentSettingsManager::GetOriginOrURL(frame),
@@ -272,7 +272,7 @@ void ContentSettingsObserver::RequestFileSystemAccessAsync(
   bool allow = true;
   GURL secondary_url(
       blink::WebStringToGURL(frame->GetSecurityOrigin().ToString()));
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
           ContentSettingsManager::GetOriginOrURL(frame),
@@ -295,7 +295,7 @@ bool ContentSettingsObserver::AllowImage(bool enabled_per_settings,
 
   bool allow = enabled_per_settings;
   GURL secondary_url(image_url);
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
             ContentSettingsManager::GetOriginOrURL(
@@ -320,7 +320,7 @@ bool ContentSettingsObserver::AllowIndexedDB(const WebString& name,
   bool allow = true;
   GURL secondary_url(
       blink::WebStringToGURL(frame->GetSecurityOrigin().ToString()));
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
             ContentSettingsManager::GetOriginOrURL(frame),
@@ -345,7 +345,7 @@ bool ContentSettingsObserver::AllowScript(bool enabled_per_settings) {
     return it->second;
 
   bool allow = enabled_per_settings;
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
           ContentSettingsManager::GetOriginOrURL(frame),
@@ -368,7 +368,7 @@ bool ContentSettingsObserver::AllowScriptFromSource(
 
   bool allow = enabled_per_settings;
   GURL secondary_url(script_url);
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
           ContentSettingsManager::GetOriginOrURL(render_frame()->GetWebFrame()),
@@ -401,7 +401,7 @@ bool ContentSettingsObserver::AllowStorage(bool local) {
     return permissions->second;
 
   bool allow = true;
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
           ContentSettingsManager::GetOriginOrURL(frame),
@@ -454,7 +454,7 @@ bool ContentSettingsObserver::AllowMutationEvents(bool default_value) {
     return true;
 
   bool allow = default_value;
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
             ContentSettingsManager::GetOriginOrURL(
@@ -476,7 +476,7 @@ bool ContentSettingsObserver::AllowRunningInsecureContent(
   // TODO(bridiver) is origin different than web frame top origin?
   bool allow = allowed_per_settings;
   GURL secondary_url(resource_url);
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     allow =
         content_settings_manager_->GetSetting(
             ContentSettingsManager::GetOriginOrURL(
@@ -495,7 +495,7 @@ bool ContentSettingsObserver::AllowRunningInsecureContent(
 
 bool ContentSettingsObserver::AllowAutoplay(bool default_value) {
   bool allow = default_value;
-  if (content_settings_manager_->content_settings()) {
+  if (content_settings_manager_->has_content_settings()) {
     WebFrame* frame = render_frame()->GetWebFrame();
     auto origin = frame->ToWebLocalFrame()->GetDocument().GetSecurityOrigin();
     allow =
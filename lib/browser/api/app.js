@@ -59,8 +59,9 @@ app.postMessage = function (message) {
   app.emit('app-post-message', {}, message)
 }
 
-function Worker (module_name) {
+function Worker (module_name, options) {
   this.module_name = module_name
+  this.pooled = !!(options && options.pooled)
   this.lastError = null
   this.__onerror = null
   this.onmessage = null
@@ -68,16 +69,30 @@ function Worker (module_name) {
 
 Worker.prototype.start = function (cb) {
   cb && this.once('start', cb)
-  this.id = app._startWorker(this.module_name)
+  if (this.pooled) {
+    this.id = app._startPooledWorker(this.module_name)
+  } else {
+    this.id = app._startWorker(this.module_name)
+  }
 }
 
-Worker.prototype.postMessage = function (message) {
+// ArrayBuffers in |transferList| are moved to the worker instead of being
+// copied and can't be used here afterwards.
+Worker.prototype.postMessage = function (message, transferList) {
   const evt = {data: message}
-  app._postMessage(this.id, evt)
+  if (this.pooled) {
+    app._postPooledMessage(this.id, evt, transferList)
+  } else {
+    app._postMessage(this.id, evt, transferList)
+  }
 }
 
 Worker.prototype.terminate = function () {
-  app.stopWorker(this.id)
+  if (this.pooled) {
+    app.stopPooledWorker(this.id)
+  } else {
+    app.stopWorker(this.id)
+  }
 }
 
 Object.defineProperty(Worker.prototype, 'onerror', {
@@ -90,29 +105,31 @@ Object.defineProperty(Worker.prototype, 'onerror', {
 
 Object.setPrototypeOf(Worker.prototype, EventEmitter.prototype)
 
-app.createWorker = function (module_name) {
-  const worker = new Worker(module_name)
+app.createWorker = function (module_name, options) {
+  const worker = new Worker(module_name, options)
+  // Pooled workers are identified by job id in their own events
+  const prefix = worker.pooled ? 'worker-pool-' : 'worker-'
 
   // It is always safe to call the worker methods because
   // WorkerThreadRegistry will return a dummy task runner
-  app.on('worker-start', (e, worker_id) => {
+  app.on(prefix + 'start', (e, worker_id) => {
     if (worker.id === worker_id) {
       worker.emit('start', {})
     }
   })
-  app.on('worker-stop', (e, worker_id) => {
+  app.on(prefix + 'stop', (e, worker_id) => {
     if (worker.id === worker_id) {
       worker.emit('stop', {})
     }
   })
-  app.on('worker-post-message', (e, worker_id, message) => {
+  app.on(prefix + 'post-message', (e, worker_id, message) => {
     if (worker.id === worker_id) {
       const event = {data: message}
       worker.emit('message', event)
       worker.onmessage && worker.onmessage(event)
     }
   })
-  app.on('worker-onerror', (e, worker_id, message, stack) => {
+  app.on(prefix + 'onerror', (e, worker_id, message, stack) => {
     worker.lastError = message
     if (worker.id === worker_id) {
       worker.onerror && worker.onerror(message, stack)
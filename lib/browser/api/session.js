@@ -1,6 +1,6 @@
 const {EventEmitter} = require('events')
 const {app} = require('electron')
-const {fromPartition, getAllSessions, Session} = process.atomBinding('session')
+const {fromPartition, getAllSessions, Cookies, Session} = process.atomBinding('session')
 
 // Public API.
 Object.defineProperties(exports, {
@@ -19,6 +19,39 @@ Object.defineProperties(exports, {
 })
 
 Object.setPrototypeOf(Session.prototype, EventEmitter.prototype)
+Object.setPrototypeOf(Cookies.prototype, EventEmitter.prototype)
+
+// Cookie changes are only sent over from the IO thread while "changed" has
+// listeners, the native side is told whenever that changes.
+const updateListened = function (cookies, names) {
+  for (const name of names) {
+    if (typeof name === 'string') {
+      cookies._setEventListened(name, cookies.listenerCount(name) > 0)
+    }
+  }
+}
+
+for (const method of ['on', 'addListener', 'prependListener']) {
+  Cookies.prototype[method] = function (name, listener) {
+    EventEmitter.prototype[method].call(this, name, listener)
+    updateListened(this, [name])
+    return this
+  }
+}
+
+Cookies.prototype.removeListener = function (name, listener) {
+  EventEmitter.prototype.removeListener.call(this, name, listener)
+  updateListened(this, [name])
+  return this
+}
+Cookies.prototype.off = Cookies.prototype.removeListener
+
+Cookies.prototype.removeAllListeners = function (...args) {
+  const names = args.length === 0 ? this.eventNames() : [args[0]]
+  EventEmitter.prototype.removeAllListeners.apply(this, args)
+  updateListened(this, names)
+  return this
+}
 
 Session.prototype._init = function () {
   app.emit('session-created', this)
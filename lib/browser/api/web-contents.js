@@ -91,6 +91,39 @@ const {WebContents} = binding
 Object.setPrototypeOf(NavigationController.prototype, EventEmitter.prototype)
 Object.setPrototypeOf(WebContents.prototype, NavigationController.prototype)
 
+// Tell the native side which events have listeners, so it does not emit the
+// ones nobody listens to. once() and prependOnceListener() go through on()
+// and prependListener().
+const updateListened = function (contents, names) {
+  for (const name of names) {
+    if (typeof name === 'string') {
+      contents._setEventListened(name, contents.listenerCount(name) > 0)
+    }
+  }
+}
+
+for (const method of ['on', 'addListener', 'prependListener']) {
+  WebContents.prototype[method] = function (name, listener) {
+    EventEmitter.prototype[method].call(this, name, listener)
+    updateListened(this, [name])
+    return this
+  }
+}
+
+WebContents.prototype.removeListener = function (name, listener) {
+  EventEmitter.prototype.removeListener.call(this, name, listener)
+  updateListened(this, [name])
+  return this
+}
+WebContents.prototype.off = WebContents.prototype.removeListener
+
+WebContents.prototype.removeAllListeners = function (...args) {
+  const names = args.length === 0 ? this.eventNames() : [args[0]]
+  EventEmitter.prototype.removeAllListeners.apply(this, args)
+  updateListened(this, names)
+  return this
+}
+
 // WebContents::send(channel, args..)
 WebContents.prototype.sendShared = function (channel, shared) {
   if (channel == null) throw new Error('Missing required `channel` argument')
@@ -249,5 +282,9 @@ module.exports = {
 
   getAllWebContents () {
     return binding.getAllWebContents()
+  },
+
+  getEventStats () {
+    return binding.getEventStats()
   }
 }
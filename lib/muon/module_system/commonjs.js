@@ -1,6 +1,7 @@
 const path = requireNative('path')
+const moduleCompiler = requireNative('module_compiler')
 
-const commonjs = function (fn, exports, modulePath, __global__) {
+const commonjs = function (fn, exports, modulePath, __global__, scope) {
   // convert module.exports to exports.$set
   const exportsHandler = {
     set: (target, name, value) => {
@@ -65,7 +66,7 @@ const commonjs = function (fn, exports, modulePath, __global__) {
   }
 
   try {
-    fn.apply(__global__, [requireProxy, moduleProxy, console])
+    fn.apply(__global__, [requireProxy, moduleProxy, console].concat(scope || []))
   } catch (e) {
     if (__global__.onerror) {
       __global__.onerror(e)
@@ -75,3 +76,7 @@ const commonjs = function (fn, exports, modulePath, __global__) {
 }
 
 exports.$set('require', commonjs)
+// |scope| holds the ModuleSystem wrapper's arguments, see AsarSourceMap
+exports.$set('requireCompiled', function (moduleName, exports, modulePath, __global__, scope) {
+  commonjs(moduleCompiler.compile(moduleName), exports, modulePath, __global__, scope)
+})
@@ -334,4 +334,25 @@ describe('app module', function () {
       assert.equal(typeof app.isAccessibilitySupportEnabled(), 'boolean')
     })
   })
+
+  describe('app.createWorker(moduleName, {pooled: true})', function () {
+    const pooledWorker = remote.require(path.join(__dirname, 'fixtures', 'module', 'pooled-worker.js'))
+
+    it('delivers a message posted right after start', function (done) {
+      pooledWorker.echoFirstMessage({hello: 'pool'}, function (error, data) {
+        assert.equal(error, null)
+        assert.deepEqual(data, {hello: 'pool'})
+        done()
+      })
+    })
+
+    it('moves transferred ArrayBuffers to the worker', function (done) {
+      pooledWorker.transferBuffer(1024, 42, function (error, senderByteLength, result) {
+        assert.equal(error, null)
+        assert.equal(senderByteLength, 0)
+        assert.deepEqual(result, {byteLength: 1024, intact: true})
+        done()
+      })
+    })
+  })
 })
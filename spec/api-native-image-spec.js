@@ -59,4 +59,134 @@ describe('nativeImage module', () => {
       assert.equal(image.getSize().width, 256)
     })
   })
+
+  describe('async encoding and decoding', () => {
+    const logoPath = path.join(__dirname, 'fixtures', 'assets', 'logo.png')
+    const image = nativeImage.createFromPath(logoPath)
+
+    const assertSameImage = (actual, expected) => {
+      assert(!actual.isEmpty())
+      assert.deepEqual(actual.getSize(), expected.getSize())
+      assert(actual.toBitmap().equals(expected.toBitmap()))
+    }
+
+    it('toPNG(callback) encodes the same image as toPNG()', (done) => {
+      image.toPNG((buffer) => {
+        assertSameImage(nativeImage.createFromBuffer(buffer),
+                        nativeImage.createFromBuffer(image.toPNG()))
+        done()
+      })
+    })
+
+    it('toJPEG(quality, callback) encodes an image of the same size', (done) => {
+      image.toJPEG(80, (buffer) => {
+        assert(buffer.length > 0)
+        const decoded = nativeImage.createFromBuffer(buffer)
+        assert.deepEqual(decoded.getSize(), image.getSize())
+        assert.deepEqual(decoded.getSize(),
+                         nativeImage.createFromBuffer(image.toJPEG(80)).getSize())
+        done()
+      })
+    })
+
+    it('toDataURL(callback) encodes the same image as toDataURL()', (done) => {
+      image.toDataURL((dataURL) => {
+        assert(dataURL.startsWith('data:image/png;base64,'))
+        assertSameImage(nativeImage.createFromDataURL(dataURL),
+                        nativeImage.createFromDataURL(image.toDataURL()))
+        done()
+      })
+    })
+
+    it('createFromPath(path, callback) decodes the same image', (done) => {
+      nativeImage.createFromPath(logoPath, (decoded) => {
+        assertSameImage(decoded, image)
+        done()
+      })
+    })
+
+    it('createFromPath(path, callback) passes an empty image for invalid paths', (done) => {
+      nativeImage.createFromPath('does-not-exist.png', (decoded) => {
+        assert(decoded.isEmpty())
+        done()
+      })
+    })
+
+    it('createFromBuffer(buffer, callback) decodes the same image', (done) => {
+      const buffer = image.toPNG()
+      nativeImage.createFromBuffer(buffer, (decoded) => {
+        assertSameImage(decoded, nativeImage.createFromBuffer(buffer))
+        done()
+      })
+    })
+
+    it('createFromDataURL(dataURL, callback) decodes the same image', (done) => {
+      const dataURL = image.toDataURL()
+      nativeImage.createFromDataURL(dataURL, (decoded) => {
+        assertSameImage(decoded, nativeImage.createFromDataURL(dataURL))
+        done()
+      })
+    })
+
+    it('encodeImages encodes every image in order', (done) => {
+      const small = image.resize({width: 100})
+      nativeImage.encodeImages([image, small], {format: 'png'}, (buffers) => {
+        assert.equal(buffers.length, 2)
+        assertSameImage(nativeImage.createFromBuffer(buffers[0]), image)
+        assertSameImage(nativeImage.createFromBuffer(buffers[1]), small)
+        done()
+      })
+    })
+  })
+
+  describe('resize(options)', () => {
+    const image = nativeImage.createFromPath(
+        path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+
+    it('keeps the aspect ratio when only the width is given', () => {
+      assert.deepEqual(image.resize({width: 269}).getSize(),
+                       {width: 269, height: 95})
+    })
+
+    it('keeps the aspect ratio when only the height is given', () => {
+      assert.deepEqual(image.resize({height: 95}).getSize(),
+                       {width: 269, height: 95})
+    })
+
+    it('uses both dimensions when given', () => {
+      assert.deepEqual(image.resize({width: 100, height: 100, quality: 'good'}).getSize(),
+                       {width: 100, height: 100})
+    })
+
+    it('returns an empty image for empty sizes', () => {
+      assert(image.resize({width: 0}).isEmpty())
+      assert(nativeImage.createEmpty().resize({width: 10}).isEmpty())
+    })
+
+    it('passes an image of the same size to the callback', (done) => {
+      image.resize({width: 269}, (resized) => {
+        assert.deepEqual(resized.getSize(), image.resize({width: 269}).getSize())
+        done()
+      })
+    })
+  })
+
+  describe('crop(rect)', () => {
+    const image = nativeImage.createFromPath(
+        path.join(__dirname, 'fixtures', 'assets', 'logo.png'))
+
+    it('returns the area of the image', () => {
+      assert.deepEqual(image.crop({x: 10, y: 20, width: 30, height: 40}).getSize(),
+                       {width: 30, height: 40})
+    })
+
+    it('clamps the area to the bounds of the image', () => {
+      assert.deepEqual(image.crop({x: 500, y: 150, width: 100, height: 100}).getSize(),
+                       {width: 38, height: 40})
+    })
+
+    it('returns an empty image for areas outside of the image', () => {
+      assert(image.crop({x: 600, y: 0, width: 10, height: 10}).isEmpty())
+    })
+  })
 })
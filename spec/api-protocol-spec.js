@@ -308,6 +308,115 @@ describe('protocol module', function () {
     })
   })
 
+  describe('protocol.registerStreamProtocol', function () {
+    var readFromText = function (offset, size, callback) {
+      callback(Buffer.from(text.substr(offset, size)))
+    }
+
+    it('sends the body in chunks', function (done) {
+      var handler = function (request, callback) {
+        callback({mimeType: 'text/plain', read: readFromText})
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data) {
+            assert.equal(data, text)
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('serves Range requests when the length is known', function (done) {
+      var handler = function (request, callback) {
+        callback({mimeType: 'text/plain', length: text.length, read: readFromText})
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          headers: {Range: 'bytes=6-11'},
+          success: function (data, status, xhr) {
+            assert.equal(xhr.status, 206)
+            assert.equal(data, text.substr(6, 6))
+            assert.equal(xhr.getResponseHeader('Content-Range'),
+                         'bytes 6-11/' + text.length)
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('sends an empty body', function (done) {
+      var handler = function (request, callback) {
+        callback({
+          mimeType: 'text/plain',
+          length: 0,
+          read: function (offset, size, callback) {
+            callback(null)
+          }
+        })
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function (data, status, xhr) {
+            assert.equal(xhr.status, 200)
+            assert.equal(data, '')
+            done()
+          },
+          error: function (xhr, errorType, error) {
+            done(error)
+          }
+        })
+      })
+    })
+
+    it('fails the request when read reports an error', function (done) {
+      var handler = function (request, callback) {
+        callback({
+          read: function (offset, size, callback) {
+            callback(-2)
+          }
+        })
+      }
+      protocol.registerStreamProtocol(protocolName, handler, function (error) {
+        if (error) {
+          return done(error)
+        }
+        $.ajax({
+          url: protocolName + '://fake-host',
+          cache: false,
+          success: function () {
+            done('request succeeded but it should not')
+          },
+          error: function (xhr, errorType) {
+            assert.equal(errorType, 'error')
+            done()
+          }
+        })
+      })
+    })
+  })
+
   describe('protocol.registerFileProtocol', function () {
     var filePath = path.join(__dirname, 'fixtures', 'asar', 'a.asar', 'file1')
     var fileContent = require('fs').readFileSync(filePath)
@@ -881,6 +990,136 @@ describe('protocol module', function () {
     })
   })
 
+  describe('protocol response cache', function () {
+    var url = protocolName + '://fake-host/cached'
+    var handlerCalls = 0
+
+    var request = function (callback) {
+      // jQuery's cache: false would change the url of every request.
+      $.ajax({
+        url: url,
+        success: function (data) {
+          assert.equal(data, text)
+          callback()
+        },
+        error: function (xhr, errorType, error) {
+          callback(error || errorType)
+        }
+      })
+    }
+
+    var registerCached = function (hints, callback) {
+      var handler = function (request, callback) {
+        handlerCalls++
+        callback(Object.assign({mimeType: 'text/plain', data: text}, hints))
+      }
+      protocol.registerStringProtocol(protocolName, handler, callback)
+    }
+
+    beforeEach(function (done) {
+      handlerCalls = 0
+      protocol.clearResponseCache(done)
+    })
+
+    it('answers repeated requests without calling the handler', function (done) {
+      registerCached({immutable: true}, function (error) {
+        if (error) return done(error)
+        protocol.getResponseCacheStats(function (before) {
+          request(function (error) {
+            if (error) return done(error)
+            request(function (error) {
+              if (error) return done(error)
+              assert.equal(handlerCalls, 1)
+              protocol.getResponseCacheStats(function (after) {
+                assert.equal(after.hits - before.hits, 1)
+                assert.equal(after.entries, 1)
+                assert.equal(after.size, text.length)
+                done()
+              })
+            })
+          })
+        })
+      })
+    })
+
+    it('does not cache responses without hints', function (done) {
+      registerCached({}, function (error) {
+        if (error) return done(error)
+        request(function (error) {
+          if (error) return done(error)
+          request(function (error) {
+            if (error) return done(error)
+            assert.equal(handlerCalls, 2)
+            done()
+          })
+        })
+      })
+    })
+
+    it('calls the handler again once maxAge expired', function (done) {
+      registerCached({maxAge: 1}, function (error) {
+        if (error) return done(error)
+        request(function (error) {
+          if (error) return done(error)
+          request(function (error) {
+            if (error) return done(error)
+            assert.equal(handlerCalls, 1)
+            setTimeout(function () {
+              request(function (error) {
+                if (error) return done(error)
+                assert.equal(handlerCalls, 2)
+                done()
+              })
+            }, 1500)
+          })
+        })
+      })
+    })
+
+    it('is cleared when the protocol is unregistered', function (done) {
+      registerCached({immutable: true}, function (error) {
+        if (error) return done(error)
+        request(function (error) {
+          if (error) return done(error)
+          protocol.unregisterProtocol(protocolName, function (error) {
+            if (error) return done(error)
+            protocol.getResponseCacheStats(function (stats) {
+              assert.equal(stats.entries, 0)
+              registerCached({immutable: true}, function (error) {
+                if (error) return done(error)
+                request(function (error) {
+                  if (error) return done(error)
+                  assert.equal(handlerCalls, 2)
+                  done()
+                })
+              })
+            })
+          })
+        })
+      })
+    })
+
+    it('is emptied by clearResponseCache', function (done) {
+      registerCached({immutable: true}, function (error) {
+        if (error) return done(error)
+        request(function (error) {
+          if (error) return done(error)
+          protocol.clearResponseCache(function () {
+            protocol.getResponseCacheStats(function (stats) {
+              assert.equal(stats.entries, 0)
+              assert.equal(stats.size, 0)
+              request(function (error) {
+                if (error) return done(error)
+                assert.equal(handlerCalls, 2)
+                done()
+              })
+            })
+          })
+        })
+      })
+    })
+  })
+
   describe('protocol.registerStandardSchemes', function () {
     const standardScheme = remote.getGlobal('standardScheme')
     const origin = standardScheme + '://fake-host'
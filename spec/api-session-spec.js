@@ -179,6 +179,138 @@ describe('session module', function () {
         })
       })
     })
+
+    describe('bulk and indexed operations', function () {
+      const ses = session.fromPartition('cookies-index-test')
+      const siteCookies = [
+        {url: 'http://a.example.com', name: 'a', value: '1'},
+        {url: 'http://b.example.com', name: 'b', value: '2', domain: '.example.com'},
+        {url: 'http://example.org', name: 'c', value: '3'},
+        {url: 'http://a.example.org', name: 'd', value: '4'}
+      ]
+      const names = function (list) {
+        return list.map(function (cookie) { return cookie.name }).sort()
+      }
+
+      beforeEach(function (done) {
+        ses.cookies.removeMany({}, function (error) {
+          if (error) return done(error)
+          ses.cookies.setMany(siteCookies, function (error, results) {
+            if (error) return done(error)
+            assert.deepEqual(results, [null, null, null, null])
+            done()
+          })
+        })
+      })
+
+      it('reports the cookies that could not be set', function (done) {
+        ses.cookies.setMany([
+          {url: 'http://example.net', name: 'e', value: '5'},
+          {url: '', name: 'f', value: '6'}
+        ], function (error, results) {
+          assert.equal(error.message, 'Setting cookie failed')
+          assert.equal(results.length, 2)
+          assert.equal(results[0], null)
+          assert.equal(results[1].message, 'Setting cookie failed')
+          ses.cookies.get({domain: 'example.net'}, function (error, list) {
+            if (error) return done(error)
+            assert.deepEqual(names(list), ['e'])
+            done()
+          })
+        })
+      })
+
+      it('gets only the cookies of the registrable domain', function (done) {
+        ses.cookies.get({domain: 'example.com'}, function (error, list) {
+          if (error) return done(error)
+          assert.deepEqual(names(list), ['a', 'b'])
+          ses.cookies.get({domain: 'a.example.org'}, function (error, list) {
+            if (error) return done(error)
+            assert.deepEqual(names(list), ['d'])
+            done()
+          })
+        })
+      })
+
+      it('filters the cookies of a domain by name', function (done) {
+        ses.cookies.get({domain: 'example.com', name: 'b'}, function (error, list) {
+          if (error) return done(error)
+          assert.equal(list.length, 1)
+          assert.equal(list[0].domain, '.example.com')
+          assert.equal(list[0].value, '2')
+          done()
+        })
+      })
+
+      it('sees cookies set after the index was loaded', function (done) {
+        ses.cookies.get({domain: 'example.com'}, function (error) {
+          if (error) return done(error)
+          ses.cookies.set({url: 'http://c.example.com', name: 'g', value: '7'}, function (error) {
+            if (error) return done(error)
+            ses.cookies.get({domain: 'example.com'}, function (error, list) {
+              if (error) return done(error)
+              assert.deepEqual(names(list), ['a', 'b', 'g'])
+              done()
+            })
+          })
+        })
+      })
+
+      it('removes only the cookies of the registrable domain', function (done) {
+        ses.cookies.removeMany({domain: 'example.com'}, function (error, removedCount) {
+          if (error) return done(error)
+          assert.equal(removedCount, 2)
+          ses.cookies.get({}, function (error, list) {
+            if (error) return done(error)
+            assert.deepEqual(names(list), ['c', 'd'])
+            done()
+          })
+        })
+      })
+
+      it('removes only the cookies matching the filter', function (done) {
+        ses.cookies.removeMany({domain: 'example.org', name: 'd'}, function (error, removedCount) {
+          if (error) return done(error)
+          assert.equal(removedCount, 1)
+          ses.cookies.get({}, function (error, list) {
+            if (error) return done(error)
+            assert.deepEqual(names(list), ['a', 'b', 'c'])
+            done()
+          })
+        })
+      })
+
+      it('emits changed when a cookie is set and removed', function (done) {
+        const events = []
+        const listener = function (event, cookie, cause, removed) {
+          if (cookie.name !== 'h') return
+          events.push([cause, removed])
+          if (events.length < 2) return
+          ses.cookies.removeListener('changed', listener)
+          assert.deepEqual(events, [['explicit', false], ['explicit', true]])
+          done()
+        }
+        ses.cookies.on('changed', listener)
+        ses.cookies.set({url: 'http://example.com', name: 'h', value: '8'}, function (error) {
+          if (error) return done(error)
+          ses.cookies.remove('http://example.com', 'h', function () {})
+        })
+      })
+
+      it('emits changed again once listeners are added back', function (done) {
+        const first = function () {}
+        ses.cookies.on('changed', first)
+        ses.cookies.removeListener('changed', first)
+        ses.cookies.once('changed', function (event, cookie, cause, removed) {
+          assert.equal(cookie.name, 'i')
+          assert.equal(removed, false)
+          done()
+        })
+        ses.cookies.set({url: 'http://example.com', name: 'i', value: '9'}, function (error) {
+          if (error) return done(error)
+        })
+      })
+    })
   })
 
   describe('ses.clearStorageData(options)', function () {
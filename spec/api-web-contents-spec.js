@@ -90,6 +90,138 @@ describe('webContents module', function () {
     })
   })
 
+  describe('getEventStats() API', function () {
+    it('counts the events without listeners as skipped', function (done) {
+      w.webContents.once('did-finish-load', function () {
+        const stats = webContents.getEventStats()
+        assert.ok(stats['dom-ready'].skipped > 0)
+        done()
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'a.html'))
+    })
+
+    it('skips an event again once its listeners are removed', function (done) {
+      let skipped = 0
+      w.webContents.once('dom-ready', function () {
+        const stats = webContents.getEventStats()
+        skipped = stats['dom-ready'] ? stats['dom-ready'].skipped : 0
+      })
+      w.webContents.once('did-finish-load', function () {
+        assert.equal(w.webContents.listenerCount('dom-ready'), 0)
+        w.webContents.once('did-finish-load', function () {
+          const stats = webContents.getEventStats()
+          assert.equal(stats['dom-ready'].skipped, skipped + 1)
+          done()
+        })
+        w.loadURL('file://' + path.join(fixtures, 'pages', 'b.html'))
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'a.html'))
+    })
+
+    it('skips an event again after removeListener', function (done) {
+      const listener = function () {
+        done('unexpected dom-ready')
+      }
+      w.webContents.on('dom-ready', listener)
+      w.webContents.removeListener('dom-ready', listener)
+
+      const stats = webContents.getEventStats()
+      const skipped = stats['dom-ready'] ? stats['dom-ready'].skipped : 0
+      w.webContents.once('did-finish-load', function () {
+        assert.equal(webContents.getEventStats()['dom-ready'].skipped, skipped + 1)
+        done()
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'a.html'))
+    })
+  })
+
+  describe('captureThumbnail(options, callback) API', function () {
+    beforeEach(function (done) {
+      w.webContents.once('did-finish-load', function () { done() })
+      w.showInactive()
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'a.html'))
+    })
+
+    it('reuses the thumbnail captured less than minInterval ago', function (done) {
+      w.webContents.captureThumbnail({minInterval: 60000}, function (first) {
+        assert.ok(first)
+        w.webContents.captureThumbnail({minInterval: 60000}, function (second) {
+          assert.ok(second)
+          assert.equal(second.id, first.id)
+          assert.equal(second.capturedAt, first.capturedAt)
+          done()
+        })
+      })
+    })
+
+    it('captures a new thumbnail when forced', function (done) {
+      w.webContents.captureThumbnail({minInterval: 60000}, function (first) {
+        assert.ok(first)
+        w.webContents.captureThumbnail({minInterval: 60000, force: true}, function (second) {
+          assert.ok(second)
+          assert.notEqual(second.id, first.id)
+          done()
+        })
+      })
+    })
+
+    it('fits the thumbnail in the requested size', function (done) {
+      w.webContents.captureThumbnail({size: {width: 100, height: 50}}, function (thumbnail) {
+        assert.ok(thumbnail)
+        assert.ok(thumbnail.size.width <= 100)
+        assert.ok(thumbnail.size.height <= 50)
+        done()
+      })
+    })
+
+    it('returns the JPEG data from getThumbnail()', function (done) {
+      assert.equal(w.webContents.getThumbnail(), null)
+      w.webContents.captureThumbnail(function (thumbnail) {
+        assert.ok(thumbnail)
+        const data = w.webContents.getThumbnail()
+        assert.ok(Buffer.isBuffer(data))
+        assert.equal(data[0], 0xFF)
+        assert.equal(data[1], 0xD8)
+        done()
+      })
+    })
+  })
+
+  describe('setEventCoalescing(enable[, interval]) API', function () {
+    it('emits the pending coalesced events before the next event', function (done) {
+      // The interval outlasts the test, so coalesced events only arrive
+      // when another event flushes them.
+      w.webContents.setEventCoalescing(true, 60000)
+
+      const events = []
+      w.webContents.on('load-progress-changed', function (event, progress) {
+        events.push(progress)
+      })
+      w.webContents.once('did-stop-loading', function () {
+        events.push('did-stop-loading')
+        setTimeout(function () {
+          const index = events.indexOf('did-stop-loading')
+          assert.ok(index > 0)
+          assert.equal(index, events.length - 1)
+
+          // Only the latest pending progress is emitted.
+          const progress = events.slice(0, index)
+          for (let i = 1; i < progress.length; i++) {
+            assert.ok(progress[i] >= progress[i - 1])
+          }
+          done()
+        }, 100)
+      })
+      w.loadURL('file://' + path.join(fixtures, 'pages', 'a.html'))
+    })
+
+    it('throws for a negative interval', function () {
+      assert.throws(function () {
+        w.webContents.setEventCoalescing(true, -1)
+      }, /must not be negative/)
+    })
+  })
+
   describe('isFocused() API', function () {
     it('returns false when the window is hidden', function () {
       BrowserWindow.getAllWindows().forEach(function (window) {
@@ -1,5 +1,6 @@
 const assert = require('assert')
 const http = require('http')
+const path = require('path')
 const qs = require('querystring')
 const remote = require('electron').remote
 const session = remote.session
@@ -11,6 +12,14 @@ describe('webRequest module', function () {
       res.statusCode = 301
       res.setHeader('Location', 'http://' + req.rawHeaders[1])
       res.end()
+    } else if (req.url === '/large') {
+      res.end(Buffer.alloc(64 * 1024, 'a'))
+    } else if (req.url === '/truncated') {
+      res.setHeader('Content-Length', 64 * 1024)
+      res.write(Buffer.alloc(1024, 'a'))
+      setTimeout(function () { res.socket.destroy() }, 100)
+    } else if (req.url === '/method') {
+      res.end(req.method)
     } else {
       res.setHeader('Custom', ['Header'])
       var content = req.url
@@ -433,6 +442,90 @@ describe('webRequest module', function () {
     })
   })
 
+  describe('webRequest.onCompleted with batch', function () {
+    var filter = null
+
+    beforeEach(function () {
+      filter = {urls: [defaultURL + '*'], batch: true}
+    })
+
+    afterEach(function () {
+      ses.webRequest.onCompleted(null)
+    })
+
+    var request = function (path) {
+      $.ajax({url: defaultURL + path})
+    }
+
+    it('passes the queued details objects in a batch', function (done) {
+      var urls = []
+      filter.batchInterval = 100
+      ses.webRequest.onCompleted(filter, function (batch) {
+        assert.ok(Array.isArray(batch.events))
+        assert.ok(batch.events.length > 0)
+        assert.equal(batch.dropped, 0)
+        batch.events.forEach(function (details) {
+          assert.equal(details.statusCode, 200)
+          urls.push(details.url)
+        })
+        if (urls.length === 3) {
+          assert.deepEqual(urls.sort(), [
+            defaultURL + 'a', defaultURL + 'b', defaultURL + 'c'
+          ])
+          done()
+        }
+      })
+      request('a')
+      request('b')
+      request('c')
+    })
+
+    it('counts the events beyond maxBatchSize as dropped', function (done) {
+      var received = 0
+      var dropped = 0
+      filter.batchInterval = 500
+      filter.maxBatchSize = 1
+      ses.webRequest.onCompleted(filter, function (batch) {
+        assert.equal(batch.events.length, 1)
+        received += batch.events.length
+        dropped += batch.dropped
+        if (received + dropped === 3) {
+          assert.ok(dropped > 0)
+          done()
+        }
+      })
+      request('a')
+      request('b')
+      request('c')
+    })
+
+    it('does not flush the queue of a replaced listener', function (done) {
+      this.timeout(5000)
+      filter.batchInterval = 200
+      ses.webRequest.onCompleted(filter, function () {
+        done('unexpected batch for the replaced listener')
+      })
+      $.ajax({
+        url: defaultURL + 'a',
+        success: function () {
+          filter.batchInterval = 1000
+          var replaced = Date.now()
+          ses.webRequest.onCompleted(filter, function (batch) {
+            assert.equal(batch.events.length, 1)
+            assert.equal(batch.events[0].url, defaultURL + 'b')
+            // Not flushed early by the flush of the replaced listener.
+            assert.ok(Date.now() - replaced >= 1000)
+            done()
+          })
+          request('b')
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+  })
+
   describe('webRequest.onErrorOccurred', function () {
     afterEach(function () {
       ses.webRequest.onErrorOccurred(null)
@@ -457,4 +550,164 @@ describe('webRequest module', function () {
       })
     })
   })
+
+  describe('webRequest.setDeclarativeRules', function () {
+    afterEach(function () {
+      ses.webRequest.setDeclarativeRules(null)
+      ses.webRequest.onBeforeRequest(null)
+      ses.webRequest.onHeadersReceived(null)
+      ses.webRequest.onErrorOccurred(null)
+    })
+
+    it('blocks the request', function (done) {
+      ses.webRequest.setDeclarativeRules([
+        {urls: [defaultURL + 'blocked'], action: 'block'}
+      ])
+      ses.webRequest.onErrorOccurred(function (details) {
+        assert.equal(details.error, 'net::ERR_BLOCKED_BY_CLIENT')
+        done()
+      })
+      $.ajax({
+        url: defaultURL + 'blocked',
+        success: function () {
+          done('unexpected success')
+        }
+      })
+    })
+
+    it('redirects the request', function (done) {
+      ses.webRequest.setDeclarativeRules([{
+        urls: [defaultURL + 'from'],
+        action: 'redirect',
+        redirectURL: defaultURL + 'to'
+      }])
+      $.ajax({
+        url: defaultURL + 'from',
+        success: function (data) {
+          assert.equal(data, '/to')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('sets the request headers', function (done) {
+      ses.webRequest.setDeclarativeRules([{
+        urls: [defaultURL + '*'],
+        setRequestHeaders: {Accept: '*/*;test/header'}
+      }])
+      $.ajax({
+        url: defaultURL,
+        success: function (data) {
+          assert.equal(data, '/header/received')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('sets the response headers before the listeners see them', function (done) {
+      ses.webRequest.setDeclarativeRules([{
+        urls: [defaultURL + '*'],
+        setResponseHeaders: {Custom: 'Rule'},
+        removeResponseHeaders: ['Content-Length']
+      }])
+      ses.webRequest.onHeadersReceived(function (details, callback) {
+        assert.equal(details.responseHeaders['Custom'], 'Rule')
+        assert.equal(details.responseHeaders['Content-Length'], undefined)
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL,
+        success: function (data, status, xhr) {
+          assert.equal(xhr.getResponseHeader('Custom'), 'Rule')
+          assert.equal(data, '/')
+          done()
+        },
+        error: function (xhr, errorType) {
+          done(errorType)
+        }
+      })
+    })
+
+    it('does not call onBeforeRequest for requests handled by a rule', function (done) {
+      ses.webRequest.setDeclarativeRules([
+        {urls: [defaultURL + 'blocked'], action: 'block'}
+      ])
+      ses.webRequest.onBeforeRequest(function (details, callback) {
+        if (details.url === defaultURL + 'blocked') {
+          done('unexpected onBeforeRequest call')
+        }
+        callback({})
+      })
+      $.ajax({
+        url: defaultURL + 'blocked',
+        success: function () {
+          done('unexpected success')
+        },
+        error: function () {
+          // Requests not matching the rule still reach the listener.
+          $.ajax({
+            url: defaultURL,
+            success: function (data) {
+              assert.equal(data, '/')
+              done()
+            },
+            error: function (xhr, errorType) {
+              done(errorType)
+            }
+          })
+        }
+      })
+    })
+
+    it('throws for invalid rules', function () {
+      assert.throws(function () {
+        ses.webRequest.setDeclarativeRules([{action: 'redirect'}])
+      }, /redirectURL/)
+    })
+  })
+
+  describe('webRequest.fetch', function () {
+    const fetchWriter = remote.require(path.join(__dirname, 'fixtures', 'module', 'fetch-writer.js'))
+
+    it('sends DELETE requests', function (done) {
+      ses.webRequest.fetch(defaultURL + 'method', {method: 'DELETE'}, function (error, response, body) {
+        assert.equal(error, null)
+        assert.equal(body, 'DELETE')
+        done()
+      })
+    })
+
+    it('throws for unknown methods', function () {
+      assert.throws(function () {
+        ses.webRequest.fetch(defaultURL + 'method', {method: 'BOGUS'}, function () {})
+      }, /invalid method/)
+    })
+
+    it('only reads the next chunk once the writer called next', function (done) {
+      fetchWriter.fetchWithWriter(defaultURL + 'large', 50, function (error, statusCode, sizes, overlapped, body) {
+        assert.equal(error, null)
+        assert.equal(statusCode, 200)
+        assert(sizes.length > 1)
+        assert.equal(overlapped, false)
+        assert.equal(sizes.reduce((a, b) => a + b, 0), 64 * 1024)
+        assert.equal(body, '')
+        done()
+      })
+    })
+
+    it('reports errors that happen while writing', function (done) {
+      fetchWriter.fetchWithWriter(defaultURL + 'truncated', 0, function (error, statusCode, sizes) {
+        assert.notEqual(error, null)
+        assert.equal(typeof error.errorCode, 'number')
+        assert(sizes.reduce((a, b) => a + b, 0) < 64 * 1024)
+        done()
+      })
+    })
+  })
 })
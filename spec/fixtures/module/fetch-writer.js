@@ -0,0 +1,22 @@
+// Runs webRequest.fetch with a writer in the browser process, where the
+// chunks are handed to JS, and reports back through |callback|.
+const {session} = require('electron')
+
+// Holds on to each chunk for |delay| ms before asking for the next one.
+exports.fetchWithWriter = function (url, delay, callback) {
+  const sizes = []
+  let holding = false
+  let overlapped = false
+  const writer = function (chunk, next) {
+    if (holding) overlapped = true
+    holding = true
+    sizes.push(chunk.byteLength)
+    setTimeout(function () {
+      holding = false
+      next()
+    }, delay)
+  }
+  session.defaultSession.webRequest.fetch(url, {writer}, function (error, response, body) {
+    callback(error, response.statusCode, sizes, overlapped, body)
+  })
+}
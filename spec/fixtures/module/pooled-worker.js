@@ -0,0 +1,32 @@
+// Drives pooled workers from the browser process, where app.createWorker
+// lives, and reports back through |callback|.
+const {app} = require('electron')
+
+// Module names are resolved against the source root.
+const echoModule = 'spec/fixtures/workers/pooled_echo'
+const transferModule = 'spec/fixtures/workers/pooled_transfer'
+
+exports.echoFirstMessage = function (message, callback) {
+  const worker = app.createWorker(echoModule, {pooled: true})
+  worker.once('message', (event) => {
+    worker.terminate()
+    callback(null, event.data)
+  })
+  worker.start()
+  // Posted before the job has even been handed to a pool thread.
+  worker.postMessage(message)
+}
+
+exports.transferBuffer = function (size, fill, callback) {
+  const worker = app.createWorker(transferModule, {pooled: true})
+  const buffer = new ArrayBuffer(size)
+  new Uint8Array(buffer).fill(fill)
+  let senderByteLength
+  worker.once('message', (event) => {
+    worker.terminate()
+    callback(null, senderByteLength, event.data)
+  })
+  worker.start()
+  worker.postMessage({buffer, fill}, [buffer])
+  senderByteLength = buffer.byteLength
+}
@@ -0,0 +1,3 @@
+self.onmessage = function (event) {
+  self.postMessage(event.data)
+}
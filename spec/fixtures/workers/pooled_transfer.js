@@ -0,0 +1,7 @@
+self.onmessage = function (event) {
+  const bytes = new Uint8Array(event.data.buffer)
+  self.postMessage({
+    byteLength: bytes.length,
+    intact: bytes.every((byte) => byte === event.data.fill)
+  })
+}